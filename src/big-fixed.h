@@ -0,0 +1,162 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// big-fixed.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Signed fixed-point numbers with many more bits than a double, for the
+// few calculations that have to stay exact deep inside a fractal zoom.
+// A BigFixed<N> is made of N 32-bit limbs in two's complement: the top
+// limb is the integer part, the other N-1 limbs are the fraction.
+// Only what the demos need is here: add, subtract, multiply, and
+// conversion from/to doubles and decimal strings.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef BIG_FIXED_H
+#define BIG_FIXED_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+template <int N> class BigFixed {
+public:
+    BigFixed() { memset(limb_, 0, sizeof(limb_)); }
+
+    // fraction bits
+    static int precision() { return 32 * (N - 1); }
+
+    static BigFixed FromDouble(double d) {
+        BigFixed r;
+        double x = fabs(d);
+        double ip = floor(x);
+        r.limb_[N-1] = (uint32_t)ip;
+        x -= ip;
+        for (int i = N - 2; i >= 0 && x > 0; i--) {
+            x *= 4294967296.0;  // 2^32
+            ip = floor(x);
+            r.limb_[i] = (uint32_t)ip;
+            x -= ip;
+        }
+        return (d < 0) ? -r : r;
+    }
+
+    // Parses a decimal number such as "-0.5778161231234567890123".
+    // Returns false if there is anything but digits, one '.' and a sign.
+    static bool FromString(const char *s, BigFixed *result) {
+        bool neg = false;
+        if (*s == '-' || *s == '+') { neg = (*s == '-'); s++; }
+        const char *dot = strchr(s, '.');
+        const char *end = s + strlen(s);
+        if (dot == NULL) dot = end;
+        if (s == end) return false;
+
+        uint32_t ip = 0;
+        for (const char *p = s; p < dot; p++) {
+            if (*p < '0' || *p > '9') return false;
+            ip = ip * 10 + (*p - '0');
+        }
+        // fraction digits, least significant first: x = (x + d) / 10
+        BigFixed r;
+        for (const char *p = end - 1; p > dot; p--) {
+            if (*p < '0' || *p > '9') return false;
+            r.limb_[N-1] = *p - '0';
+            r.DivSmall(10);
+        }
+        r.limb_[N-1] = ip;
+        *result = neg ? -r : r;
+        return true;
+    }
+
+    double ToDouble() const {
+        if (negative()) return -(-*this).ToDouble();
+        double d = 0;
+        for (int i = 0; i < N; i++) {
+            d += ldexp((double)limb_[i], 32 * (i - (N - 1)));
+        }
+        return d;
+    }
+
+    bool negative() const { return (limb_[N-1] & 0x80000000u) != 0; }
+
+    BigFixed operator-() const {
+        BigFixed r;
+        uint64_t carry = 1;
+        for (int i = 0; i < N; i++) {
+            carry += (uint32_t)~limb_[i];
+            r.limb_[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        return r;
+    }
+
+    BigFixed operator+(const BigFixed &b) const {
+        BigFixed r;
+        uint64_t carry = 0;
+        for (int i = 0; i < N; i++) {
+            carry += (uint64_t)limb_[i] + b.limb_[i];
+            r.limb_[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        return r;
+    }
+
+    BigFixed operator-(const BigFixed &b) const { return *this + (-b); }
+
+    // Truncating multiply. The integer part must stay in range.
+    BigFixed operator*(const BigFixed &b) const {
+        const bool neg = negative() != b.negative();
+        const BigFixed x = negative() ? -*this : *this;
+        const BigFixed y = b.negative() ? -b : b;
+
+        // we only need the product limbs from N-2 up (N-2 for the carries)
+        uint32_t prod[2 * N];
+        memset(prod, 0, sizeof(prod));
+        for (int i = 0; i < N; i++) {
+            if (x.limb_[i] == 0) continue;
+            uint64_t carry = 0;
+            int j = (N - 2 - i > 0) ? N - 2 - i : 0;
+            for (; j < N; j++) {
+                carry += (uint64_t)x.limb_[i] * y.limb_[j] + prod[i + j];
+                prod[i + j] = (uint32_t)carry;
+                carry >>= 32;
+            }
+            for (int k = i + N; carry != 0 && k < 2 * N; k++) {
+                carry += prod[k];
+                prod[k] = (uint32_t)carry;
+                carry >>= 32;
+            }
+        }
+        BigFixed r;
+        memcpy(r.limb_, prod + (N - 1), N * sizeof(uint32_t));
+        return neg ? -r : r;
+    }
+
+private:
+    // unsigned divide by a small number, in place
+    void DivSmall(uint32_t d) {
+        uint64_t rem = 0;
+        for (int i = N - 1; i >= 0; i--) {
+            rem = (rem << 32) | limb_[i];
+            limb_[i] = (uint32_t)(rem / d);
+            rem %= d;
+        }
+    }
+
+    uint32_t limb_[N];  // least significant first
+};
+
+#endif  // BIG_FIXED_H
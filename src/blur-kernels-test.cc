@@ -0,0 +1,156 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// blur-kernels-test
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Checks that the kernels in blur-kernels.h give exactly the pixels of the
+// blur loops they replaced, which are copied below as they were. The old
+// loops read up to two rows past the end of the buffer, so both run on
+// buffers followed by zeros, and only the picture itself is compared.
+//
+// Whichever kernels the compiler picks are tested; 'make test' builds this
+// once as is and once with BLUR_NO_SIMD. Add e.g. TEST_FLAGS=-mavx2 to test
+// the AVX2 ones on a machine that has it.
+//
+//  ./blur-kernels-test
+//
+// --------------------------------------------------------------------------------
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#include "blur-kernels.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define MAX_WIDTH 139
+#define MAX_HEIGHT 40
+#define RUNS 4   // random pictures per size
+
+// --------------------------------------------------------------------------------
+// The loops as they were in blur.cc, hack.cc and words.cc
+
+void oldBox(int width, int height, uint8_t pixels[], int drop) {
+
+    int size = width * (height - 1) - 1;
+    uint8_t dot;
+    for (int i=0; i < size; i++) {
+        dot = (uint8_t)((pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) >> 2) & 0xFF;
+        if (dot <= drop) { dot = 0; }
+        else { dot -= drop; }
+        pixels[i] = dot;
+    }
+}
+
+void oldCenter(int width, int height, uint8_t pixels[]) {
+
+    int size = width * (height - 1) - 1;
+    uint8_t dot;
+    for (int i=0; i < size; i++) {
+        dot = (uint8_t)(( (pixels[i] << 2) +
+            (pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) ) >> 3) & 0xFF;
+        if (dot > 0) { dot--; }
+        pixels[i] = dot;
+    }
+}
+
+void oldFire(int width, int height, uint8_t pixels[], int orient) {
+
+    const int step = 4;
+    int size = width * (height - 1) - 1;
+    uint8_t dot;
+
+    if (orient == 0) {
+        for (int i=1; i < size; i++) {
+            dot = (uint8_t)(( pixels[i - 1] + pixels[i + 1] + pixels[i + width - 1] + pixels[i + width]
+                + pixels[i + width + 1] + pixels[i + 2*width - 1] + pixels[i + 2*width] + pixels[i + 2*width + 1]
+                ) >> 3) & 0xFF;
+            if (dot <= step) { dot = 0; } else { dot -= step; }
+            pixels[i] = dot;
+        }
+    }
+    else {
+        for (int i=1; i < size; i++) {
+            if (i % width == 0) continue;
+            dot = (uint8_t)(( pixels[i - 1] + pixels[i] + pixels[i + 1] + pixels[i + width]
+                + pixels[i + width + 1] + pixels[i + 2*width - 1] + pixels[i + 2*width] + pixels[i + 2*width + 1]
+                ) >> 3) & 0xFF;
+            if (dot <= step) { dot = 0; } else { dot -= step; }
+            pixels[i + width - 1] = dot;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------
+
+enum { BOX, BOX_WORDS, CENTER, FIRE_UP, FIRE_LEFT, KERNELS };
+const char *kNames[KERNELS] = { "blurBox", "blurBox (drop 32)", "blurCenter", "blurFireUp", "blurFireLeft" };
+
+void runOld(int kernel, int width, int height, uint8_t pixels[]) {
+    switch (kernel) {
+    case BOX:       oldBox(width, height, pixels, 8); break;
+    case BOX_WORDS: oldBox(width, height, pixels, 32); break;
+    case CENTER:    oldCenter(width, height, pixels); break;
+    case FIRE_UP:   oldFire(width, height, pixels, 0); break;
+    case FIRE_LEFT: oldFire(width, height, pixels, 1); break;
+    }
+}
+
+void runNew(int kernel, int width, int height, uint8_t pixels[]) {
+    switch (kernel) {
+    case BOX:       blurBox(pixels, width * (height - 1) - 1, width, 8); break;
+    case BOX_WORDS: blurBox(pixels, width * (height - 1) - 1, width, 32); break;
+    case CENTER:    blurCenter(pixels, width * (height - 1) - 1, width, 1); break;
+    case FIRE_UP:   blurFireUp(pixels, width, height, 4); break;
+    case FIRE_LEFT: blurFireLeft(pixels, width, height, 4); break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    srandom(1);
+    int failed = 0, tests = 0;
+    for (int kernel=0; kernel < KERNELS; kernel++) {
+        for (int width=2; width <= MAX_WIDTH; width++) {
+            for (int height=2; height <= MAX_HEIGHT; height += 3) {
+                const int size = width * height;
+                for (int run=0; run < RUNS; run++) {
+                    // the old loops read up to two rows and a pixel past the end
+                    std::vector<uint8_t> old_pixels(size + 2 * width + 1, 0);
+                    for (int i=0; i < size; i++) {
+                        // noise, or nearly white to check the sums don't overflow
+                        old_pixels[i] = (run & 1) ? random() & 0xFF : 255 - (random() & 0x1F);
+                    }
+                    std::vector<uint8_t> new_pixels = old_pixels;
+                    runOld(kernel, width, height, &old_pixels[0]);
+                    runNew(kernel, width, height, &new_pixels[0]);
+                    tests++;
+                    if (memcmp(&old_pixels[0], &new_pixels[0], size) != 0) {
+                        if (failed < 10) {
+                            fprintf(stderr, "%s differs at %dx%d\n", kNames[kernel], width, height);
+                        }
+                        failed++;
+                    }
+                }
+            }
+        }
+    }
+    printf("%d of %d blurs match (%d lanes)\n", tests - failed, tests, BLUR_LANES);
+    return failed ? 1 : 0;
+}
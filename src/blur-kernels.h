@@ -0,0 +1,214 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// blur-kernels.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// The blurs of the blur, hack and words demos, on 16 or 32 pixels at a
+// time where the compiler has SSE2, AVX2 or NEON, and one at a time where
+// it doesn't. All of them give exactly the same pixels as the plain loops
+// they replace.
+//
+// Each pixel becomes the sum of some of its neighbours, shifted down, less
+// a 'drop' that can't go below 0. The blurs work in place, front to back,
+// and most only look at pixels further on, which haven't changed yet, so
+// whole blocks can be done at once. The fire blurs also look back at
+// pixels they already changed, so only the sums of the others are done
+// in blocks.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef BLUR_KERNELS_H
+#define BLUR_KERNELS_H
+
+#include <stdint.h>
+
+// define BLUR_NO_SIMD to get the one-at-a-time versions anyway
+#if defined(BLUR_NO_SIMD)
+#define BLUR_LANES 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define BLUR_AVX2
+#define BLUR_LANES 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define BLUR_SSE2
+#define BLUR_LANES 16
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BLUR_NEON
+#define BLUR_LANES 16
+#else
+#define BLUR_LANES 1
+#endif
+
+// dst[0 .. BLUR_LANES-1] = (sum of src[offsets[k]] for k < count) >> shift,
+// less 'drop'. All of src is read before dst is written. The sums are
+// done in 16 bits, as averaging instructions round and the loops didn't.
+static inline void blurLanes(uint8_t *dst, const uint8_t *src, const int *offsets, int count,
+                             int shift, uint8_t drop) {
+#if defined(BLUR_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = zero, hi = zero;
+    for (int k=0; k < count; k++) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(src + offsets[k]));
+        lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(v, zero));
+        hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(v, zero));
+    }
+    const __m128i s = _mm_cvtsi32_si128(shift);
+    // unpack and pack both work within 128 bit halves, so the order comes out right
+    const __m256i sum = _mm256_packus_epi16(_mm256_srl_epi16(lo, s), _mm256_srl_epi16(hi, s));
+    _mm256_storeu_si256((__m256i *)dst, _mm256_subs_epu8(sum, _mm256_set1_epi8(drop)));
+#elif defined(BLUR_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = zero, hi = zero;
+    for (int k=0; k < count; k++) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(src + offsets[k]));
+        lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+        hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+    }
+    const __m128i s = _mm_cvtsi32_si128(shift);
+    const __m128i sum = _mm_packus_epi16(_mm_srl_epi16(lo, s), _mm_srl_epi16(hi, s));
+    _mm_storeu_si128((__m128i *)dst, _mm_subs_epu8(sum, _mm_set1_epi8(drop)));
+#elif defined(BLUR_NEON)
+    uint16x8_t lo = vdupq_n_u16(0), hi = vdupq_n_u16(0);
+    for (int k=0; k < count; k++) {
+        const uint8x16_t v = vld1q_u8(src + offsets[k]);
+        lo = vaddw_u8(lo, vget_low_u8(v));
+        hi = vaddw_u8(hi, vget_high_u8(v));
+    }
+    const int16x8_t s = vdupq_n_s16(-shift);
+    const uint8x16_t sum = vcombine_u8(vqmovn_u16(vshlq_u16(lo, s)), vqmovn_u16(vshlq_u16(hi, s)));
+    vst1q_u8(dst, vqsubq_u8(sum, vdupq_n_u8(drop)));
+#else
+    int sum = 0;
+    for (int k=0; k < count; k++) { sum += src[offsets[k]]; }
+    sum >>= shift;
+    dst[0] = (sum > drop) ? sum - drop : 0;
+#endif
+}
+
+// out[0 .. BLUR_LANES-1] = sum of src[offsets[k]] for k < count
+static inline void blurSums(uint16_t *out, const uint8_t *src, const int *offsets, int count) {
+#if defined(BLUR_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = zero, hi = zero;
+    for (int k=0; k < count; k++) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(src + offsets[k]));
+        lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(v, zero));
+        hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(v, zero));
+    }
+    // lo has pixels 0-7 and 16-23, hi 8-15 and 24-31
+    _mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(out + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+#elif defined(BLUR_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = zero, hi = zero;
+    for (int k=0; k < count; k++) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(src + offsets[k]));
+        lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+        hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+    }
+    _mm_storeu_si128((__m128i *)out, lo);
+    _mm_storeu_si128((__m128i *)(out + 8), hi);
+#elif defined(BLUR_NEON)
+    uint16x8_t lo = vdupq_n_u16(0), hi = vdupq_n_u16(0);
+    for (int k=0; k < count; k++) {
+        const uint8x16_t v = vld1q_u8(src + offsets[k]);
+        lo = vaddw_u8(lo, vget_low_u8(v));
+        hi = vaddw_u8(hi, vget_high_u8(v));
+    }
+    vst1q_u16(out, lo);
+    vst1q_u16(out + 8, hi);
+#else
+    int sum = 0;
+    for (int k=0; k < count; k++) { sum += src[offsets[k]]; }
+    out[0] = sum;
+#endif
+}
+
+// p[i] = (p[i] + p[i+1] + p[i+stride] + p[i+stride+1]) / 4 - drop, for i < n
+static inline void blurBox(uint8_t *p, int n, int stride, uint8_t drop) {
+    const int offsets[4] = { 0, 1, stride, stride + 1 };
+    int i = 0;
+    for (; i + BLUR_LANES <= n; i += BLUR_LANES) { blurLanes(p + i, p + i, offsets, 4, 2, drop); }
+    for (; i < n; i++) {
+        const int dot = (p[i] + p[i + 1] + p[i + stride] + p[i + stride + 1]) >> 2;
+        p[i] = (dot > drop) ? dot - drop : 0;
+    }
+}
+
+// p[i] = (5 p[i] + p[i+1] + p[i+stride] + p[i+stride+1]) / 8 - drop, for i < n
+static inline void blurCenter(uint8_t *p, int n, int stride, uint8_t drop) {
+    const int offsets[8] = { 0, 0, 0, 0, 0, 1, stride, stride + 1 };
+    int i = 0;
+    for (; i + BLUR_LANES <= n; i += BLUR_LANES) { blurLanes(p + i, p + i, offsets, 8, 3, drop); }
+    for (; i < n; i++) {
+        const int dot = ((p[i] << 2) + p[i] + p[i + 1] + p[i + stride] + p[i + stride + 1]) >> 3;
+        p[i] = (dot > drop) ? dot - drop : 0;
+    }
+}
+
+// Flames rising: every pixel but the first becomes the average of the
+// pixel before it (already blurred) and the 3x2 block below it and its
+// right neighbour, less 'drop'. Pixels past the end count as 0.
+static inline void blurFireUp(uint8_t *p, int width, int height, uint8_t drop) {
+    const int size = width * (height - 1) - 1;
+    const int total = width * height;
+    const int offsets[7] = { 1, width - 1, width, width + 1, 2*width - 1, 2*width, 2*width + 1 };
+    uint16_t sums[BLUR_LANES];
+    int i = 1;
+    for (; i + BLUR_LANES - 1 < size && i + BLUR_LANES + 2*width < total; i += BLUR_LANES) {
+        blurSums(sums, p + i, offsets, 7);
+        for (int k=0; k < BLUR_LANES; k++) {
+            const int dot = (p[i + k - 1] + sums[k]) >> 3;
+            p[i + k] = (dot > drop) ? dot - drop : 0;
+        }
+    }
+    for (; i < size; i++) {
+        int sum = p[i - 1];
+        for (int k=0; k < 7; k++) { sum += (i + offsets[k] < total) ? p[i + offsets[k]] : 0; }
+        const int dot = sum >> 3;
+        p[i] = (dot > drop) ? dot - drop : 0;
+    }
+}
+
+// Flames going left: pixel i+width-1 becomes the average of pixel
+// i+width and its neighbours but the one on the left, less 'drop', for
+// every i not in the first column. Pixels past the end count as 0.
+static inline void blurFireLeft(uint8_t *p, int width, int height, uint8_t drop) {
+    const int size = width * (height - 1) - 1;
+    const int total = width * height;
+    const int offsets[8] = { -1, 0, 1, width, width + 1, 2*width - 1, 2*width, 2*width + 1 };
+    for (int row=0; row < size; row += width) {
+        int i = row + 1;
+        const int end = (row + width < size) ? row + width : size;
+        // a block may not read what it writes itself, pixel i+1 is written
+        // width-2 pixels later
+        if (BLUR_LANES <= width - 2) {
+            for (; i + BLUR_LANES <= end && i + BLUR_LANES + 2*width < total; i += BLUR_LANES) {
+                blurLanes(p + i + width - 1, p + i, offsets, 8, 3, drop);
+            }
+        }
+        for (; i < end; i++) {
+            int sum = 0;
+            for (int k=0; k < 8; k++) { sum += (i + offsets[k] < total) ? p[i + offsets[k]] : 0; }
+            const int dot = sum >> 3;
+            p[i + width - 1] = (dot > drop) ? dot - drop : 0;
+        }
+    }
+}
+
+#endif  // BLUR_KERNELS_H
@@ -42,6 +42,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "blur-kernels.h"
 
 #include <getopt.h>
 #include <stdio.h>
@@ -391,29 +392,15 @@ void clearBottomRow(int width, int height, int orient, uint8_t pixels[]) {
 
 void blur1(int width, int height, uint8_t pixels[]) {
 
-    int size = width * (height - 1) - 1;
-    uint8_t dot;
     // blur effect
-    for (int i=0; i < size; i++) {
-        dot = (uint8_t)((pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) >> 2) & 0xFF;
-        if (dot <= 8) { dot = 0; }
-        else { dot -= 8; }
-        pixels[i] = dot;
-    }
+    blurBox(pixels, width * (height - 1) - 1, width, 8);
 }
 
 // NOT USED
 void blur2(int width, int height, uint8_t pixels[]) {
 
-    int size = width * (height - 1) - 1;
-    uint8_t dot;
     // blur effect
-    for (int i=0; i < size; i++) {
-        dot = (uint8_t)(( (pixels[i] << 2) +
-            (pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) ) >> 3) & 0xFF;
-        if (dot > 0) { dot--; }
-        pixels[i] = dot;
-    }
+    blurCenter(pixels, width * (height - 1) - 1, width, 1);
 }
 
 // Blur that works without the black border. Use this one.
@@ -423,12 +410,8 @@ void blur3(int width, int height, uint8_t pixels[]) {
     uint8_t dot;
     int i=0;
     for (int y=0; y < height - 1; y++) {
-        for (int x=0; x < width - 1; x++) {
-            dot = (uint8_t)((pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) >> 2) & 0xFF;
-            dot = (dot <= 8) ? 0 : dot - 8;
-            pixels[i] = dot;
-            i++;
-        }
+        blurBox(&pixels[i], width - 1, width, 8);
+        i += width - 1;
         // blur right border pixel
         dot = (uint8_t)((pixels[i] + pixels[i + width]) >> 2) & 0xFF;
         dot = (dot <= 8) ? 0 : dot - 8;
@@ -450,30 +433,15 @@ void blur3(int width, int height, uint8_t pixels[]) {
 void blurFire(int width, int height, int orient, uint8_t pixels[]) {
 
     const int step = 4;
-    int size = width * (height - 1) - 1;
-    uint8_t dot;
 
     // TODO: redo this like blur3() to handle right border
     if (orient == 0) {
         // flame upwards (default orientation)
-        for (int i=1; i < size; i++) {
-            dot = (uint8_t)(( pixels[i - 1] + pixels[i + 1] + pixels[i + width - 1] + pixels[i + width]
-                + pixels[i + width + 1] + pixels[i + 2*width - 1] + pixels[i + 2*width] + pixels[i + 2*width + 1]
-                ) >> 3) & 0xFF;
-            if (dot <= step) { dot = 0; } else { dot -= step; }
-            pixels[i] = dot;
-        }
+        blurFireUp(pixels, width, height, step);
     }
     else {
         // flame leftwards (orient = 1)
-        for (int i=1; i < size; i++) {
-            if (i % width == 0) continue;
-            dot = (uint8_t)(( pixels[i - 1] + pixels[i] + pixels[i + 1] + pixels[i + width]
-                + pixels[i + width + 1] + pixels[i + 2*width - 1] + pixels[i + 2*width] + pixels[i + 2*width + 1]
-                ) >> 3) & 0xFF;
-            if (dot <= step) { dot = 0; } else { dot -= step; }
-            pixels[i + width - 1] = dot;
-        }
+        blurFireLeft(pixels, width, height, step);
     }
 }
 
@@ -0,0 +1,294 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// ca-board.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Cellular automata with any rule from ca-rule.h, 64 cells to a word.
+//
+// CaBoard runs two dimensional B/S and Generations rules on a wrap-around
+// board. The neighbours of 64 cells are added up bit-parallel like in
+// LifeBoard, only into a full four bit count, which the rule's birth and
+// survival tables then pick from. Generations states are kept as a binary
+// number spread over several bit planes, so fading cells count up in
+// parallel too.
+//
+// WolframBoard runs a one dimensional rule and shows its history, the
+// newest row at the top. Cells past the ends are dead. The history is a
+// ring of rows, so scrolling it down moves the head instead of the rows.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef CA_BOARD_H
+#define CA_BOARD_H
+
+#include "ca-rule.h"
+#include "life-engine.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+class CaBoard : public LifeEngine {
+public:
+    CaBoard(int width, int height, const CaRule &rule)
+        : width_(width), height_(height), words_((width + 63) / 64), steps_(1),
+          states_(rule.states), planes_(1) {
+        while ((1 << planes_) < states_) { planes_++; }
+        last_mask_ = (width % 64) ? (1ULL << (width % 64)) - 1 : ~0ULL;
+        top_ = (width - 1) & 63;
+        cur_.resize(planes_ * words_ * height, 0);
+        next_.resize(cur_.size(), 0);
+        alive_.resize(words_ * height, 0);
+        // the neighbour counts that give birth or survival
+        for (int n=0; n <= 8; n++) {
+            if (rule.birth[n] || rule.survive[n]) {
+                counts_.push_back(n);
+                birth_.push_back(rule.birth[n]);
+                survive_.push_back(rule.survive[n]);
+            }
+        }
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // generations per Run()
+    void SetSteps(int steps) { steps_ = steps; }
+
+    virtual void Clear() { memset(&cur_[0], 0, cur_.size() * sizeof(uint64_t)); }
+
+    // makes the cell alive (state 1) or dead (0)
+    virtual void Set(int x, int y, bool alive) {
+        const int i = y * words_ + (x >> 6);
+        const uint64_t bit = 1ULL << (x & 63);
+        for (int p=0; p < planes_; p++) { Plane(cur_, p)[i] &= ~bit; }
+        if (alive) Plane(cur_, 0)[i] |= bit;
+    }
+
+    virtual bool Get(int x, int y) const { return State(x, y) == 1; }
+
+    virtual int State(int x, int y) const {
+        const int i = y * words_ + (x >> 6);
+        int s = 0;
+        for (int p=0; p < planes_; p++) { s |= ((Plane(cur_, p)[i] >> (x & 63)) & 1) << p; }
+        return s;
+    }
+
+    virtual int States() const { return states_; }
+
+    virtual void Run() {
+        for (int i=0; i < steps_; i++) { Step(); }
+    }
+
+    virtual uint64_t Hash() const {
+        uint64_t h = 0;
+        for (size_t i=0; i < cur_.size(); i++) { h ^= HashWord(cur_[i], i); }
+        return h;
+    }
+
+    // one generation
+    void Step() {
+        // which cells count as live neighbours: state 1
+        const int size = words_ * height_;
+        for (int i=0; i < size; i++) {
+            uint64_t a = cur_[i];
+            for (int p=1; p < planes_; p++) { a &= ~Plane(cur_, p)[i]; }
+            alive_[i] = a;
+        }
+
+        for (int y=0; y < height_; y++) {
+            const uint64_t *above = &alive_[((y + height_ - 1) % height_) * words_];
+            const uint64_t *row = &alive_[y * words_];
+            const uint64_t *below = &alive_[((y + 1) % height_) * words_];
+            for (int i=0; i < words_; i++) {
+                // neighbours above and below as 0-3, of the row itself 0-2
+                uint64_t w, e, as, ac, bs, bc;
+                Neighbours(above, i, &w, &e);
+                FullAdd(w, above[i], e, &as, &ac);
+                Neighbours(below, i, &w, &e);
+                FullAdd(w, below[i], e, &bs, &bc);
+                Neighbours(row, i, &w, &e);
+                const uint64_t hs = w ^ e, hc = w & e;
+
+                // four bit count c0 + 2 c1 + 4 c2 + 8 c3
+                uint64_t c0, k, u0, u1;
+                FullAdd(as, bs, hs, &c0, &k);
+                FullAdd(ac, bc, hc, &u0, &u1);
+                const uint64_t c1 = u0 ^ k, carry = u0 & k;
+                const uint64_t c2 = u1 ^ carry, c3 = u1 & carry;
+
+                uint64_t born = 0, survive = 0;
+                for (size_t n=0; n < counts_.size(); n++) {
+                    const int count = counts_[n];
+                    const uint64_t eq = ((count & 1) ? c0 : ~c0) & ((count & 2) ? c1 : ~c1)
+                                      & ((count & 4) ? c2 : ~c2) & ((count & 8) ? c3 : ~c3);
+                    if (birth_[n]) born |= eq;
+                    if (survive_[n]) survive |= eq;
+                }
+                NextState(y * words_ + i, row[i], born, survive);
+            }
+        }
+        cur_.swap(next_);
+    }
+
+private:
+    uint64_t *Plane(std::vector<uint64_t> &board, int p) { return &board[p * words_ * height_]; }
+    const uint64_t *Plane(const std::vector<uint64_t> &board, int p) const {
+        return &board[p * words_ * height_];
+    }
+
+    static void FullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t *sum, uint64_t *carry) {
+        const uint64_t t = a ^ b;
+        *sum = t ^ c;
+        *carry = (a & b) | (t & c);
+    }
+
+    // cells to the west (x-1) and east (x+1) of word i of a row, wrapping
+    void Neighbours(const uint64_t *row, int i, uint64_t *w, uint64_t *e) const {
+        const int last = words_ - 1;
+        *w = (row[i] << 1) | ((i > 0) ? row[i - 1] >> 63 : (row[last] >> top_) & 1);
+        *e = (row[i] >> 1);
+        if (i < last) {
+            *e |= row[i + 1] << 63;
+        } else {
+            *w &= last_mask_;
+            *e |= (row[0] & 1) << top_;
+        }
+    }
+
+    // word i of the next generation
+    void NextState(int i, uint64_t alive, uint64_t born, uint64_t survive) {
+        const uint64_t mask = ((i % words_) == words_ - 1) ? last_mask_ : ~0ULL;
+        if (planes_ == 1) {
+            next_[i] = ((alive & survive) | (~alive & born)) & mask;
+            return;
+        }
+        // empty cells may be born, live ones survive or start dying, and
+        // dying ones count up until they're dead again
+        uint64_t empty = ~0ULL;
+        for (int p=0; p < planes_; p++) { empty &= ~Plane(cur_, p)[i]; }
+        uint64_t carry = (alive & ~survive) | (~empty & ~alive);
+        uint64_t done = ~0ULL;   // state reached 'states_'
+        for (int p=0; p < planes_; p++) {
+            const uint64_t bits = Plane(cur_, p)[i];
+            const uint64_t out = bits ^ carry;
+            carry &= bits;
+            Plane(next_, p)[i] = out;
+            done &= ((states_ >> p) & 1) ? out : ~out;
+        }
+        for (int p=0; p < planes_; p++) { Plane(next_, p)[i] &= ~done & mask; }
+        Plane(next_, 0)[i] |= empty & born & mask;
+    }
+
+    int width_, height_;
+    int words_;                     // words per row
+    int steps_;
+    int states_;
+    int planes_;                    // bits per state
+    uint64_t last_mask_;            // valid bits of the last word of a row
+    int top_;                       // highest valid bit of the last word
+    std::vector<uint64_t> cur_, next_;  // 'planes_' boards of one bit each
+    std::vector<uint64_t> alive_;   // cells in state 1
+    std::vector<int> counts_;       // neighbour counts that matter
+    std::vector<bool> birth_, survive_;  // for each of counts_
+};
+
+class WolframBoard : public LifeEngine {
+public:
+    WolframBoard(int width, int height, const CaRule &rule)
+        : width_(width), height_(height), words_((width + 63) / 64), steps_(1),
+          head_(0), rows_(words_ * height, 0) {
+        last_mask_ = (width % 64) ? (1ULL << (width % 64)) - 1 : ~0ULL;
+        // the left, center, right neighbourhoods that give a live cell
+        for (int k=0; k < 8; k++) {
+            if ((rule.wolfram >> k) & 1) patterns_.push_back(k);
+        }
+    }
+
+    // rows per Run()
+    void SetSteps(int steps) { steps_ = steps; }
+
+    // The rows are a ring, display row y is ring row (head() + y) % height.
+    // Every step moves the head back by one.
+    int head() const { return head_; }
+
+    virtual void Clear() {
+        memset(&rows_[0], 0, rows_.size() * sizeof(uint64_t));
+        head_ = 0;
+    }
+
+    virtual void Set(int x, int y, bool alive) {
+        uint64_t &w = Row(y)[x >> 6];
+        const uint64_t bit = 1ULL << (x & 63);
+        w = alive ? (w | bit) : (w & ~bit);
+    }
+
+    virtual bool Get(int x, int y) const {
+        return (Row(y)[x >> 6] >> (x & 63)) & 1;
+    }
+
+    virtual void Run() {
+        for (int i=0; i < steps_; i++) { Step(); }
+    }
+
+    // in display order, so it doesn't depend on where the head is
+    virtual uint64_t Hash() const {
+        uint64_t h = 0;
+        for (int y=0; y < height_; y++) {
+            const uint64_t *row = Row(y);
+            for (int i=0; i < words_; i++) { h ^= HashWord(row[i], y * words_ + i); }
+        }
+        return h;
+    }
+
+    // compute a new top row from the current one, the oldest row drops
+    // off the bottom
+    void Step() {
+        const uint64_t *prev = Row(0);
+        head_ = (head_ + height_ - 1) % height_;
+        uint64_t *out = Row(0);
+        if (height_ == 1) {
+            prev_.assign(prev, prev + words_);
+            prev = &prev_[0];
+        }
+        for (int i=0; i < words_; i++) {
+            const uint64_t c = prev[i];
+            const uint64_t l = (c << 1) | ((i > 0) ? prev[i - 1] >> 63 : 0);
+            const uint64_t r = (c >> 1) | ((i + 1 < words_) ? prev[i + 1] << 63 : 0);
+            uint64_t next = 0;
+            for (size_t n=0; n < patterns_.size(); n++) {
+                const int k = patterns_[n];
+                next |= ((k & 4) ? l : ~l) & ((k & 2) ? c : ~c) & ((k & 1) ? r : ~r);
+            }
+            out[i] = (i == words_ - 1) ? next & last_mask_ : next;
+        }
+    }
+
+private:
+    uint64_t *Row(int y) { return &rows_[((head_ + y) % height_) * words_]; }
+    const uint64_t *Row(int y) const { return &rows_[((head_ + y) % height_) * words_]; }
+
+    int width_, height_;
+    int words_;
+    int steps_;
+    int head_;                      // ring row shown at the top
+    uint64_t last_mask_;
+    std::vector<uint64_t> rows_;    // a ring of rows
+    std::vector<uint64_t> prev_;    // copy of the one row of a 1 high board
+    std::vector<int> patterns_;
+};
+
+#endif  // CA_BOARD_H
@@ -0,0 +1,103 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// ca-rule.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Cellular automaton rules, parsed from the usual rulestrings:
+//
+//   B3/S23      born with 3 neighbours, survives with 2 or 3 (Life), or B3S23
+//   23/3        the same, in S/B order
+//   B2/S/C3     Generations: dying cells take C-2 more steps to fade out
+//   /2/3        the same, in S/B/C order (Brian's Brain)
+//   W30         Wolfram's elementary one dimensional rule 30
+//
+// A rule ends up as tables of which neighbour counts give birth and
+// survival, or for W rules the new cell for each of the 8 neighbourhoods.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef CA_RULE_H
+#define CA_RULE_H
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CA_MAX_STATES 64   // Generations rules up to this many states
+
+struct CaRule {
+    CaRule() { Parse("B3/S23"); }
+
+    // False if 'rule' isn't a rulestring this understands.
+    bool Parse(const char *rule) {
+        memset(birth, 0, sizeof(birth));
+        memset(survive, 0, sizeof(survive));
+        states = 2;
+        wolfram = -1;
+
+        if (rule[0] == 'W' || rule[0] == 'w') {
+            char *end;
+            wolfram = (int)strtol(rule + 1, &end, 10);
+            return end != rule + 1 && *end == 0 && wolfram >= 0 && wolfram < 256;
+        }
+
+        // slash separated parts, either letter prefixed or by position S/B/C
+        int part = 0;
+        for (const char *p = rule; ; part++) {
+            char kind = "SBC"[part < 3 ? part : 2];
+            if (isalpha(*p)) kind = toupper(*p++);
+            if (part > 2 || (kind != 'B' && kind != 'S' && kind != 'C' && kind != 'G')) return false;
+            if (kind == 'C' || kind == 'G') {
+                states = 0;
+                for (; isdigit(*p); p++) { states = states * 10 + (*p - '0'); }
+                if (states < 2 || states > CA_MAX_STATES) return false;
+            } else {
+                for (; isdigit(*p); p++) {
+                    if (*p == '9') return false;
+                    (kind == 'B' ? birth : survive)[*p - '0'] = true;
+                }
+            }
+            if (*p == 0) break;
+            // "B3S23" works too
+            if (*p == '/') {
+                p++;
+            } else if (!isalpha(*p)) {
+                return false;
+            }
+        }
+        // without a B0 rule nothing comes from nothing, which the engines
+        // depend on for empty space to stay empty
+        return !birth[0];
+    }
+
+    bool oneDimensional() const { return wolfram >= 0; }
+
+    // plain B3/S23, which has engines of its own
+    bool conway() const {
+        if (wolfram >= 0 || states != 2) return false;
+        for (int n=0; n <= 8; n++) {
+            if (birth[n] != (n == 3) || survive[n] != (n == 2 || n == 3)) return false;
+        }
+        return true;
+    }
+
+    bool birth[9];      // by number of live neighbours
+    bool survive[9];
+    int states;         // 2, or more for Generations
+    int wolfram;        // rule number 0-255 for W rules, else -1
+};
+
+#endif  // CA_RULE_H
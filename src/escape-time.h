@@ -0,0 +1,225 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// escape-time.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Escape-time kernel for Mandelbrot-like fractals. Iterates LANES points at
+// once using the compiler's vector extensions, which become AVX-512 (8
+// lanes), AVX (4) or SSE2 / NEON (2) registers depending on the target.
+// Compile with -march=native to get the wider ones.
+//
+// The kernel is a template on the formula, so each fractal gets its own
+// compiled loop with nothing to decide per iteration. A formula is a small
+// struct with:
+//
+//   Init(x, y, &zr, &zi, &cr, &ci)  starting z and constant c for pixel x+iy
+//   Step(zr, zi, cr, ci)            z = f(z) + c
+//   Inside(x, y)                    mask of points known never to escape
+//
+// Init and Step are templates too, so they work on plain doubles as well
+// as on vectors.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef ESCAPE_TIME_H
+#define ESCAPE_TIME_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define CYCLE_START 64   // iterations before looking for periodic orbits
+#define CYCLE_STEP 4     // iterations between periodic orbit checks
+
+#if defined(__AVX512F__)
+#define LANES 8
+#elif defined(__AVX__)
+#define LANES 4
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+#define LANES 2
+#else
+#define LANES 1
+#endif
+typedef double vdouble __attribute__((vector_size(LANES * sizeof(double))));
+typedef long long vlong __attribute__((vector_size(LANES * sizeof(long long))));
+
+// true if any lane of the mask is set
+static inline bool anyLane(const vlong &m) {
+#if LANES == 8
+    return _mm512_test_epi64_mask((__m512i)m, (__m512i)m) != 0;
+#elif LANES == 4
+    return _mm256_movemask_pd((__m256d)m) != 0;
+#elif LANES == 2 && defined(__SSE2__)
+    return _mm_movemask_pd((__m128d)m) != 0;
+#else
+    long long r = 0;
+    for (int k=0; k < LANES; k++) { r |= m[k]; }
+    return r != 0;
+#endif
+}
+
+// absolute value, for doubles and vectors
+static inline double absValue(double x) { return fabs(x); }
+static inline vdouble absValue(const vdouble &x) {
+    return (vdouble)((vlong)x & (0x7fffffffffffffffLL + (vlong){}));
+}
+
+// --------------------------------------------------------------------------------
+// Formulas
+
+// z = z^2 + c, starting at z = c
+struct Mandelbrot {
+    template <typename T> void Init(const T &x, const T &y, T *zr, T *zi, T *cr, T *ci) const {
+        *zr = *cr = x;
+        *zi = *ci = y;
+    }
+    template <typename T> void Step(T &zr, T &zi, const T &cr, const T &ci) const {
+        const T nzr = zr*zr - zi*zi + cr;
+        zi = 2 * zi * zr + ci;
+        zr = nzr;
+    }
+    // the main cardioid and the period-2 bulb
+    vlong Inside(const vdouble &x, const vdouble &y) const {
+        const vdouble y2 = y * y;
+        const vdouble xq = x - 0.25, q = xq*xq + y2;
+        const vdouble x1 = x + 1;
+        return (q * (q + xq) < 0.25 * y2) | (x1*x1 + y2 < 0.0625);
+    }
+};
+
+// z = z^2 + c for a fixed c, starting at the pixel
+struct Julia {
+    Julia(double re, double im) : c_r(re), c_i(im) {}
+    template <typename T> void Init(const T &x, const T &y, T *zr, T *zi, T *cr, T *ci) const {
+        *zr = x;
+        *zi = y;
+        *cr = T{} + c_r;
+        *ci = T{} + c_i;
+    }
+    template <typename T> void Step(T &zr, T &zi, const T &cr, const T &ci) const {
+        const T nzr = zr*zr - zi*zi + cr;
+        zi = 2 * zi * zr + ci;
+        zr = nzr;
+    }
+    vlong Inside(const vdouble &x, const vdouble &y) const { return (vlong){}; }
+
+    double c_r, c_i;
+};
+
+// z = z^N + c
+template <int N> struct Multibrot {
+    template <typename T> void Init(const T &x, const T &y, T *zr, T *zi, T *cr, T *ci) const {
+        *zr = *cr = x;
+        *zi = *ci = y;
+    }
+    template <typename T> void Step(T &zr, T &zi, const T &cr, const T &ci) const {
+        T pr = zr, pi = zi;
+        for (int k=1; k < N; k++) {
+            const T npr = pr*zr - pi*zi;
+            pi = pr*zi + pi*zr;
+            pr = npr;
+        }
+        zr = pr + cr;
+        zi = pi + ci;
+    }
+    vlong Inside(const vdouble &x, const vdouble &y) const { return (vlong){}; }
+};
+
+// z = (|re z| + i |im z|)^2 + c
+struct BurningShip {
+    template <typename T> void Init(const T &x, const T &y, T *zr, T *zi, T *cr, T *ci) const {
+        *zr = *cr = x;
+        *zi = *ci = y;
+    }
+    template <typename T> void Step(T &zr, T &zi, const T &cr, const T &ci) const {
+        const T ar = absValue(zr), ai = absValue(zi);
+        zr = ar*ar - ai*ai + cr;
+        zi = 2 * ar * ai + ci;
+    }
+    vlong Inside(const vdouble &x, const vdouble &y) const { return (vlong){}; }
+};
+
+// --------------------------------------------------------------------------------
+// Kernel
+
+// one iteration for all lanes. returns false once no lane is active.
+template <class F>
+static inline bool iterate(const F &f, vdouble &vr, vdouble &vi, const vdouble &vcr, const vdouble &vci,
+                           vlong &active, vlong &count) {
+    // lanes that escaped stay masked out
+    active &= (vr*vr + vi*vi < 4);
+    if (!anyLane(active)) return false;
+    count -= active;
+    // compute Z(n+1) given Z(n)
+    f.Step(vr, vi, vcr, vci);
+    return true;
+}
+
+// compute iteration counts for n pixels x[0..n) + i*y into dst, up to 255.
+// x must be readable up to n rounded up to LANES.
+// Points whose orbit comes back to within sqrt(eps2) of an earlier point
+// are caught in a cycle and get the full count without iterating further.
+template <class F>
+void escapeTime(const F &f, const double *x, double y, uint8_t *dst, int n, double eps2) {
+    const vdouble vy = (vdouble){} + y;  // broadcast
+    for (int i=0; i < n; i += LANES) {
+        vdouble vx;
+        memcpy(&vx, x + i, sizeof(vx));
+        vdouble vr, vi, vcr, vci;
+        f.Init(vx, vy, &vr, &vi, &vcr, &vci);
+
+        const vlong inside = f.Inside(vx, vy);
+        vlong count = inside & 255, active = ~inside;
+
+        // loop until all points are above distance 2, or counter hits limit.
+        // most points escape early, so don't look for cycles at first.
+        int c = 0;
+        while (c < CYCLE_START && iterate(f, vr, vi, vcr, vci, active, count)) { c++; }
+
+        // Brent-style cycle detection: compare against a saved point of the
+        // orbit, which is moved forward at doubling intervals. Checking only
+        // every CYCLE_STEP iterations still catches any period, just a
+        // little later, and keeps the check off the hot path.
+        vdouble sr = vr, si = vi;
+        int period = CYCLE_STEP, save_at = c + CYCLE_STEP;
+        bool running = true;
+        while (running && c < 255) {
+            for (int k=0; k < CYCLE_STEP && c < 255; k++, c++) {
+                if (!(running = iterate(f, vr, vi, vcr, vci, active, count))) break;
+            }
+            const vdouble dr = vr - sr, di = vi - si;
+            const vlong cycle = active & (dr*dr + di*di < eps2);
+            count = (count & ~cycle) | (cycle & 255);
+            active &= ~cycle;
+            if (c >= save_at) {
+                sr = vr; si = vi;
+                period *= 2;
+                save_at += period;
+            }
+        }
+
+        // store colors
+        for (int k=0; k < LANES && i + k < n; k++) {
+            dst[i + k] = (uint8_t)count[k];
+        }
+    }
+}
+
+#endif  // ESCAPE_TIME_H
@@ -41,6 +41,11 @@
 //
 
 #include "udp-flaschen-taschen.h"
+#include "thread-pool.h"
+#include "frame-timer.h"
+#include "image-scale.h"
+#include "big-fixed.h"
+#include "escape-time.h"
 #include "config.h"
 
 #include <getopt.h>
@@ -54,19 +59,77 @@
 #include <string.h>
 #include <string>
 #include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <complex>
+#include <vector>
 
 // Defaults
 #define Z_LAYER 1       // (0-15) 0=background
 #define DELAY 20
+#define CYCLE_EPS 1e-10  // periodic orbit tolerance
+#define LEVELS 38        // zoom levels (halvings) before reversing
+#define ZOOM_TIME 0.5    // fastest zoom, in seconds per level
+#define MAX_LEVELS 1000  // deepest zoom, limited by the range of doubles
+#define MAX_SIZE 16383   // widest or tallest display zoomFractal() can scale
+#define PREC_LIMBS 36    // 32-bit limbs for the zoom point & reference orbit
+#define DEEP_PRECISION 1e-13   // pixel spacing relative to the point where doubles run out
+#define DEEP_ITERATIONS 4      // extra iterations per level past that
+#define SERIES_TOL 1e-12
+#define FIND_GRID 8        // candidate cells per side when looking for a target
+#define FIND_SAMPLES 16    // escape-time samples per cell side
+#define FIND_INTERIOR 0.5  // cells with more of the set inside than this are too flat
+#define FIND_PICK 0.7      // choose randomly among cells scoring this close to the best
+#define JULIA_RADIUS 0.7885  // Julia mode: c goes around a circle this size
+#define JULIA_SPEED 0.25     // radians per second
+#define JULIA_VIEW 1.2       // half-height of the view
 
 // define the point in the complex plane to which we will zoom into
 #define POINT_OR  -0.577816-9.31323E-10-1.16415E-10
 #define POINT_OI  -0.631121-2.38419E-07+1.49012E-08
 
+typedef BigFixed<PREC_LIMBS> Fixed;
+typedef std::complex<double> Complex;
+
 // global variables used for calculating fractal
 uint8_t *glob_frac1, *glob_frac2;
-double glob_dr, glob_di, glob_pr, glob_pi, glob_sr, glob_si;
-long glob_offs;
+double glob_dr, glob_di, glob_sr, glob_si;
+double *glob_cr;
+double glob_eps2;
+ThreadPool *glob_pool;
+ImageScaler glob_scaler;
+
+// fractal formulas, see escape-time.h
+enum { FORMULA_MANDELBROT, FORMULA_MULTIBROT3, FORMULA_MULTIBROT4, FORMULA_SHIP, FORMULA_JULIA };
+const char *formula_names[] = { "mandelbrot", "multibrot3", "multibrot4", "ship", "julia" };
+Julia glob_julia(0, 0);
+
+// point we zoom into, in full precision
+Fixed glob_point_r = Fixed::FromDouble(POINT_OR);
+Fixed glob_point_i = Fixed::FromDouble(POINT_OI);
+
+// deep zoom: pixels are computed as deltas from a reference orbit
+bool glob_deep;
+int glob_maxiter;
+std::vector<double> glob_ref_r, glob_ref_i;   // reference orbit Z(n), Z(0) = 0
+int glob_series_n;                            // iterations skipped by the series
+Complex glob_series_a, glob_series_b, glob_series_c;
+double glob_radius;                           // series is in units of this
+
+// zoom cache file: a header followed by the keyframes of each level
+#define CACHE_MAGIC "FTZ1"
+struct ZoomCacheHeader {
+    char magic[4];
+    uint32_t width, height;     // display size, keyframes are twice that
+    uint32_t levels;
+};
+uint8_t *glob_cache = NULL;     // mmap()ed cache file when playing back
+size_t glob_cache_size;
+
+// target finder: the window being searched and the score of each cell
+double glob_find_r, glob_find_i, glob_find_h;
+double glob_find_score[FIND_GRID * FIND_GRID];
 
 volatile bool interrupt_received = false;
 static void InterruptHandler(int signo) {
@@ -85,6 +148,14 @@ int opt_height = DISPLAY_HEIGHT;
 int opt_xoff=0, opt_yoff=0;
 int opt_delay  = DELAY;
 int opt_palette = -1;  // default cycles
+int opt_threads = -1;  // worker threads, default one per core
+int opt_levels = LEVELS;
+double opt_zoom_time = ZOOM_TIME;
+const char *opt_record = NULL;
+const char *opt_playback = NULL;
+bool opt_auto = false;
+bool opt_point = false;  // -c given
+int opt_formula = FORMULA_MANDELBROT;
 
 int usage(const char *progname) {
 
@@ -96,6 +167,19 @@ int usage(const char *progname) {
         "\t-t <timeout>   : Timeout exits after given seconds. (default 24hrs)\n"
         "\t-h <host>      : Flaschen-Taschen display hostname. (FT_DISPLAY)\n"
         "\t-d <delay>     : Delay between frames in milliseconds. (default 20)\n"
+        "\t-j <threads>   : Worker threads computing the fractal. (default 1 per core)\n"
+        "\t-z <levels>    : Zoom levels before reversing, up to 1000. (default 38)\n"
+        "\t                 Beyond double precision a deep zoom mode takes over.\n"
+        "\t-s <seconds>   : Fastest zoom speed in seconds per level. (default 0.5)\n"
+        "\t                 Zooms slow down if the next level isn't computed yet.\n"
+        "\t-c <re>,<im>   : Point to zoom into, any number of digits.\n"
+        "\t                 Deep zooms need a point on the edge of the set, e.g. -c 0,1\n"
+        "\t-f <formula>   : mandelbrot, multibrot3, multibrot4, ship, or julia.\n"
+        "\t                 (default mandelbrot) Julia morphs instead of zooming.\n"
+        "\t                 Only mandelbrot has a deep zoom mode.\n"
+        "\t-a             : Find a new point to zoom into every cycle.\n"
+        "\t-R <file>      : Record all zoom levels to a cache file and exit.\n"
+        "\t-P <file>      : Play back a recorded cache file. Geometry comes from the file.\n"
     );
     return 1;
 }
@@ -104,7 +188,7 @@ int cmdLine(int argc, char *argv[]) {
 
     // command line options
     int opt;
-    while ((opt = getopt(argc, argv, "?g:l:t:h:d:")) != -1) {
+    while ((opt = getopt(argc, argv, "?g:l:t:h:d:j:z:s:c:af:R:P:")) != -1) {
         switch (opt) {
         case '?':  // help
             return usage(argv[0]);
@@ -136,62 +220,428 @@ int cmdLine(int argc, char *argv[]) {
                 return usage(argv[0]);
             }
             break;
+        case 'j':  // threads
+            if (sscanf(optarg, "%d", &opt_threads) != 1 || opt_threads < 1) {
+                fprintf(stderr, "Invalid number of threads '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            // the main thread computes too
+            opt_threads--;
+            break;
+        case 'z':  // zoom levels
+            if (sscanf(optarg, "%d", &opt_levels) != 1 || opt_levels < 1 || opt_levels > MAX_LEVELS) {
+                fprintf(stderr, "Invalid zoom levels '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 's':  // zoom speed
+            if (sscanf(optarg, "%lf", &opt_zoom_time) != 1 || opt_zoom_time <= 0) {
+                fprintf(stderr, "Invalid zoom speed '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'f': {  // formula
+            const int count = sizeof(formula_names) / sizeof(formula_names[0]);
+            for (opt_formula=0; opt_formula < count; opt_formula++) {
+                if (strcmp(optarg, formula_names[opt_formula]) == 0) break;
+            }
+            if (opt_formula == count) {
+                fprintf(stderr, "Invalid formula '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        }
+        case 'a':  // auto target
+            opt_auto = true;
+            break;
+        case 'R':  // record
+            opt_record = strdup(optarg);
+            break;
+        case 'P':  // playback
+            opt_playback = strdup(optarg);
+            break;
+        case 'c': {  // zoom point
+            std::string re(optarg), im;
+            size_t comma = re.find(',');
+            if (comma != std::string::npos) {
+                im = re.substr(comma + 1);
+                re.resize(comma);
+            }
+            if (comma == std::string::npos
+                || !Fixed::FromString(re.c_str(), &glob_point_r)
+                || !Fixed::FromString(im.c_str(), &glob_point_i)) {
+                fprintf(stderr, "Invalid point '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_point = true;
+            break;
+        }
         default:
             return usage(argv[0]);
         }
     }
+    if (opt_formula == FORMULA_JULIA && (opt_record || opt_playback)) {
+        fprintf(stderr, "Julia mode can't be recorded or played back\n");
+        return usage(argv[0]);
+    }
+    // the default point is only interesting for the Mandelbrot set
+    if (opt_formula != FORMULA_MANDELBROT && opt_formula != FORMULA_JULIA && !opt_point) {
+        opt_auto = true;
+    }
     return 0;
 }
 
 // --------------------------------------------------------------------------------
 // Fractal functions
 
-// init fractal computation (MUST REDO)
-void startFractal(double sr, double si, double er, double ei) {
+// compute n pixels of a row with the selected formula
+void computeEscapeTime(const double *x, double y, uint8_t *dst, int n, double eps2) {
+    switch (opt_formula) {
+    case FORMULA_MULTIBROT3: escapeTime(Multibrot<3>(), x, y, dst, n, eps2); break;
+    case FORMULA_MULTIBROT4: escapeTime(Multibrot<4>(), x, y, dst, n, eps2); break;
+    case FORMULA_SHIP:       escapeTime(BurningShip(), x, y, dst, n, eps2); break;
+    case FORMULA_JULIA:      escapeTime(glob_julia, x, y, dst, n, eps2); break;
+    default:                 escapeTime(Mandelbrot(), x, y, dst, n, eps2); break;
+    }
+}
+
+// Deep zoom using perturbation theory. Only the reference orbit Z(n) of
+// the zoom point is computed in full precision. Every pixel c = C + dc
+// then iterates just its (small) difference d(n) = z(n) - Z(n) in doubles:
+//
+//   d(n+1) = 2 Z(n) d(n) + d(n)^2 + dc
+//
+// When z(n) gets closer to 0 than d(n), or the reference runs out, the
+// pixel is rebased onto the start of the orbit: d = z(n), n = 0.
+// The first iterations are skipped with a series approximation in dc,
+// which is the same for all pixels of the keyframe.
+void perturbRow(int j) {
+    const int w = opt_width * 2;
+    const double *ref_r = &glob_ref_r[0], *ref_i = &glob_ref_i[0];
+    const int last = (int)glob_ref_r.size() - 1;
+    double dci = glob_si;   // offsets from the point
+    for (int k=0; k < j; k++) { dci += glob_di; }
+    uint8_t *dst = glob_frac1 + (long)j * w;
+
+    for (int i=0; i < w; i++) {
+        const double dcr = glob_cr[i];
+        double dr = dcr, di = dci;
+        int n = 1;
+        if (glob_series_n > 1) {
+            // start off with the series approximation
+            const Complex u = Complex(dcr, dci) / glob_radius;
+            const Complex d = ((glob_series_c * u + glob_series_b) * u + glob_series_a) * u;
+            dr = d.real(); di = d.imag();
+            n = glob_series_n;
+        }
+        int m = n;       // index into the reference orbit
+        int c = n - 1;
+        while (c < glob_maxiter) {
+            const double zr = ref_r[m] + dr, zi = ref_i[m] + di;
+            const double mag = zr*zr + zi*zi;
+            if (mag >= 4) break;
+            c++;
+            if (m == last || mag < dr*dr + di*di) {
+                // rebase
+                dr = zr; di = zi;
+                m = 0;
+            }
+            const double ndr = 2 * (ref_r[m]*dr - ref_i[m]*di) + dr*dr - di*di + dcr;
+            di = 2 * (ref_r[m]*di + ref_i[m]*dr) + 2*dr*di + dci;
+            dr = ndr;
+            m++;
+        }
+        // store color. the palette repeats every 256 entries, 255 is inside.
+        dst[i] = (c >= glob_maxiter) ? 255 : (uint8_t)c;
+    }
+}
+
+// compute the reference orbit of the zoom point and the series
+// approximation for a keyframe of half-size zx,zy
+void referenceOrbit(double zx, double zy) {
+    // Z(n+1) = Z(n)^2 + C in full precision, until it escapes
+    glob_ref_r.clear();
+    glob_ref_i.clear();
+    Fixed zr, zi;
+    for (int n=0; n <= glob_maxiter + 1; n++) {
+        const double r = zr.ToDouble(), i = zi.ToDouble();
+        glob_ref_r.push_back(r);
+        glob_ref_i.push_back(i);
+        if (r*r + i*i > 4) break;
+        const Fixed zr2 = zr * zr, zi2 = zi * zi, zri = zr * zi;
+        zr = zr2 - zi2 + glob_point_r;
+        zi = zri + zri + glob_point_i;
+    }
+    const int last = (int)glob_ref_r.size() - 1;
+
+    // Series d(n) = A u + B u^2 + C u^3, with u = dc / radius so none of
+    // the terms underflow. Checked against four corner probes iterated
+    // exactly; stop as soon as the series isn't accurate anymore.
+    glob_radius = hypot(zx, zy);
+    const Complex probe_dc[4] = { Complex(-zx, -zy), Complex(zx, -zy),
+                                  Complex(-zx, zy), Complex(zx, zy) };
+    Complex probe[4];
+    for (int p=0; p < 4; p++) { probe[p] = probe_dc[p]; }
+    Complex a(glob_radius, 0), b(0, 0), c(0, 0);
+    int n = 1;
+    while (n + 1 < last && n + 1 < glob_maxiter) {
+        const Complex z(glob_ref_r[n], glob_ref_i[n]);
+        const Complex z1(glob_ref_r[n+1], glob_ref_i[n+1]);
+        const Complex na = 2.0 * z * a + glob_radius;
+        const Complex nb = 2.0 * z * b + a * a;
+        const Complex nc = 2.0 * z * c + 2.0 * a * b;
+        bool ok = true;
+        for (int p=0; p < 4 && ok; p++) {
+            const Complex d = 2.0 * z * probe[p] + probe[p] * probe[p] + probe_dc[p];
+            const Complex u = probe_dc[p] / glob_radius;
+            const Complex s = ((nc * u + nb) * u + na) * u;
+            // the series must match, and the probe must neither escape nor rebase
+            ok = (abs(s - d) <= SERIES_TOL * abs(d)) && (norm(z1 + d) < 4) && (norm(z1 + d) >= norm(d));
+            probe[p] = d;
+        }
+        if (!ok) break;
+        a = na; b = nb; c = nc;
+        n++;
+    }
+    glob_series_n = n;
+    glob_series_a = a;
+    glob_series_b = b;
+    glob_series_c = c;
+}
+
+// compute one row of the 2x supersampled fractal into glob_frac1
+void computeRow(int j) {
+    if (glob_deep) {
+        perturbRow(j);
+        return;
+    }
+    const int w = opt_width * 2;
+    // step down to row j the same way a sequential fill would, so the
+    // rounding matches no matter which thread computes the row
+    double pi = glob_si;
+    for (int k=0; k < j; k++) { pi += glob_di; }
+    computeEscapeTime(glob_cr, pi, glob_frac1 + (long)j * w, w, glob_eps2);
+}
+
+// init fractal computation for a view of half-size zx,zy around the zoom
+// point and start computing all rows in the background
+void startFractal(double zx, double zy) {
+    if (glob_cache) {
+        // playing back: just point at the recorded keyframe
+        const long size = opt_width * opt_height * 4;
+        int level = (int)lround(log2(4.0 / zx));
+        if (level < 0) level = 0;
+        if (level >= opt_levels) level = opt_levels - 1;
+        glob_frac1 = glob_cache + sizeof(ZoomCacheHeader) + level * size;
+        return;
+    }
+    const double pr = glob_point_r.ToDouble(), pi = glob_point_i.ToDouble();
+    double sr = pr - zx, si = pi - zy, er = pr + zx, ei = pi + zy;
+
     // compute deltas for interpolation in complex plane
     //glob_dr = (er - sr) / 640.0f;
     //glob_di = (ei - si) / 400.0f;
     glob_dr = (er - sr) / (opt_width * 2.0f);
     glob_di = (ei - si) / (opt_height * 2.0f);
+
+    // switch to perturbation once doubles can't tell pixels apart anymore
+    const double scale = fmax(1.0, fmax(fabs(pr), fabs(pi)));
+    const double spacing = 2 * zx / (opt_width * 2.0f);
+    glob_deep = (opt_formula == FORMULA_MANDELBROT) && spacing < DEEP_PRECISION * scale;
+    if (glob_deep) {
+        // deeper views need more iterations to show any detail
+        const int levels = (int)log2(DEEP_PRECISION * scale / spacing) + 1;
+        glob_maxiter = 255 + DEEP_ITERATIONS * levels;
+        referenceOrbit(zx, zy);
+        // pixels are offsets from the zoom point
+        glob_dr = spacing;
+        glob_di = 2 * zy / (opt_height * 2.0f);
+        sr = -zx;
+        si = -zy;
+    }
+
+    // orbits closer than this to an earlier point count as periodic; keep
+    // it well below the pixel spacing so it doesn't change the picture
+    double eps = fmin(CYCLE_EPS, fabs(glob_dr) * 1e-3);
+    glob_eps2 = eps * eps;
     // remember start values
-    glob_pr = sr;
-    glob_pi = si;
     glob_sr = sr;
     glob_si = si;
-    glob_offs = 0;
+    // real part of each column, interpolated along X
+    double cr = sr;
+    for (int i=0; i < opt_width * 2 + LANES; i++) {
+        glob_cr[i] = cr;
+        cr += glob_dr;
+    }
+    // rows are handed out one at a time, so slow interior rows don't hold up the rest
+    glob_pool->Start(opt_height * 2, computeRow);
 }
 
-// compute 4 lines of fractal (MUST REDO)
-void computeFractal() {
-    if ((glob_offs + 1) >= (opt_width * opt_height * 4)) {
+// wait for the computation to finish
+void waitFractal() {
+    if (!glob_cache) glob_pool->Wait();
+}
+
+// fraction of the fractal computed so far
+double readyFractal() {
+    if (glob_cache) return 1.0;
+    return (double)glob_pool->completed() / (opt_height * 2);
+}
+
+// --------------------------------------------------------------------------------
+// Target finder
+//
+// Looks for a point worth zooming into by splitting a window into a grid
+// of cells, scoring each from a few escape-time samples, and narrowing the
+// window down to a good cell. This repeats until the zoom is deep enough,
+// or no cell has enough detail left.
+
+// score one cell of the search window: lots of neighbouring samples that
+// differ, a spread of iteration counts, and some of the set itself inside
+// (so the boundary runs through it) all make for an interesting view
+void scoreCell(int n) {
+    const double cell = 2 * glob_find_h / FIND_GRID;
+    const double step = cell / FIND_SAMPLES;
+    const double x0 = glob_find_r - glob_find_h + (n % FIND_GRID) * cell + step / 2;
+    const double y0 = glob_find_i - glob_find_h + (n / FIND_GRID) * cell + step / 2;
+    double cr[FIND_SAMPLES + LANES];
+    for (int i=0; i < FIND_SAMPLES + LANES; i++) { cr[i] = x0 + i * step; }
+    uint8_t counts[FIND_SAMPLES][FIND_SAMPLES];
+    const double eps = fmin(CYCLE_EPS, step * 1e-3);
+    for (int j=0; j < FIND_SAMPLES; j++) {
+        computeEscapeTime(cr, y0 + j * step, counts[j], FIND_SAMPLES, eps * eps);
+    }
+
+    int inside = 0, edges = 0;
+    double sum = 0, sum2 = 0;
+    for (int j=0; j < FIND_SAMPLES; j++) {
+        for (int i=0; i < FIND_SAMPLES; i++) {
+            const int c = counts[j][i];
+            if (c == 255) { inside++; }
+            else { sum += c; sum2 += c * c; }
+            if (i + 1 < FIND_SAMPLES && c != counts[j][i+1]) { edges++; }
+            if (j + 1 < FIND_SAMPLES && c != counts[j+1][i]) { edges++; }
+        }
+    }
+    const int total = FIND_SAMPLES * FIND_SAMPLES, outside = total - inside;
+    if (inside > total * FIND_INTERIOR || outside == 0) {
+        glob_find_score[n] = 0;  // flat interior, or too deep for 255 iterations
         return;
     }
-    //for (int j=0; j < 4; j++) {
-    for (int j=0; j < 2; j++) {
-        glob_pr = glob_sr;
-        for (int i=0; i < (opt_width * 2); i++) {
-            uint8_t c = 0;
-            double vi = glob_pi, vr = glob_pr, nvi, nvr;
-            // loop until distance is above 2, or counter hits limit
-            while ((vr*vr + vi*vi < 4) && (c < 255)) {
-                // compute Z(n+1) given Z(n)
-                nvr = vr*vr - vi*vi + glob_pr;
-                nvi = 2 * vi * vr + glob_pi;
-                // that becomes Z(n)
-                vi = nvi;
-                vr = nvr;
-                c++;
-            }
-            // store color
-            glob_frac1[glob_offs] = c;
-            glob_offs++;
-            if (glob_offs  >= (opt_width * opt_height * 4)) { return; }
-            // interpolate X
-            glob_pr += glob_dr;
+    const double mean = sum / outside;
+    const double spread = sqrt(fmax(0, sum2 / outside - mean * mean));
+    glob_find_score[n] = edges * (1 + spread / 16) * (inside > 0 ? 2 : 1);
+}
+
+// pick a new zoom point. returns how many levels deep it stays interesting,
+// at most max_levels.
+int findTarget(int max_levels) {
+    // start with the whole set
+    glob_find_r = -0.5;
+    glob_find_i = 0;
+    glob_find_h = 2.0;
+    int levels = 1;
+    while (levels < max_levels) {
+        glob_pool->Run(FIND_GRID * FIND_GRID, scoreCell);
+
+        double best = 0;
+        for (int n=0; n < FIND_GRID * FIND_GRID; n++) { best = fmax(best, glob_find_score[n]); }
+        if (best <= 0) break;
+        // pick one of the good ones, so every cycle goes somewhere else
+        int good[FIND_GRID * FIND_GRID], num_good = 0;
+        for (int n=0; n < FIND_GRID * FIND_GRID; n++) {
+            if (glob_find_score[n] >= best * FIND_PICK) { good[num_good++] = n; }
         }
-        // interpolate Y
-        glob_pi += glob_di;
+        const int n = good[random() % num_good];
+
+        // the new window is twice the size of the cell, centered on it
+        const double cell = 2 * glob_find_h / FIND_GRID;
+        glob_find_r += ((n % FIND_GRID) + 0.5) * cell - glob_find_h;
+        glob_find_i += ((n / FIND_GRID) + 0.5) * cell - glob_find_h;
+        glob_find_h = cell;
+        levels = (int)log2(4.0 / glob_find_h);
+
+        // doubles can't resolve the window any further
+        const double scale = fmax(1.0, fmax(fabs(glob_find_r), fabs(glob_find_i)));
+        if (glob_find_h < DEEP_PRECISION * scale * FIND_GRID * FIND_SAMPLES) break;
+    }
+    glob_point_r = Fixed::FromDouble(glob_find_r);
+    glob_point_i = Fixed::FromDouble(glob_find_i);
+    return (levels < max_levels) ? levels : max_levels;
+}
+
+// --------------------------------------------------------------------------------
+// Zoom cache
+
+// compute the keyframes of all zoom levels and write them to a file
+int recordZoom(const char *filename) {
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL) {
+        perror(filename);
+        return 1;
+    }
+    ZoomCacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, 4);
+    header.width = opt_width;
+    header.height = opt_height;
+    header.levels = opt_levels;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    double zx = 4.0, zy = 4.0;
+    for (int level=0; ok && level < opt_levels && !interrupt_received; level++) {
+        fprintf(stderr, "\rRecording level %d of %d", level + 1, opt_levels);
+        startFractal( zx, zy );
+        waitFractal();
+        ok = fwrite(glob_frac1, opt_width * opt_height * 4, 1, f) == 1;
+        zx *= 0.5; zy *= 0.5;
+    }
+    fprintf(stderr, "\n");
+    if (fclose(f) != 0) ok = false;
+    if (!ok || interrupt_received) {
+        fprintf(stderr, "Could not write '%s'\n", filename);
+        unlink(filename);
+        return 1;
+    }
+    return 0;
+}
+
+// map a recorded cache file. sets the geometry and levels from the file.
+bool openZoomCache(const char *filename) {
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror(filename);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(ZoomCacheHeader)) {
+        fprintf(stderr, "'%s' is not a zoom cache file\n", filename);
+        close(fd);
+        return false;
+    }
+    glob_cache_size = st.st_size;
+    void *map = mmap(NULL, glob_cache_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
     }
+    const ZoomCacheHeader *header = (const ZoomCacheHeader *)map;
+    const size_t frame = (size_t)header->width * header->height * 4;
+    if (memcmp(header->magic, CACHE_MAGIC, 4) != 0
+        || header->width < 1 || header->width > MAX_SIZE
+        || header->height < 1 || header->height > MAX_SIZE
+        || header->levels < 1 || header->levels > MAX_LEVELS
+        || glob_cache_size < sizeof(ZoomCacheHeader) + header->levels * frame) {
+        fprintf(stderr, "'%s' is not a zoom cache file\n", filename);
+        munmap(map, glob_cache_size);
+        return false;
+    }
+    opt_width = header->width;
+    opt_height = header->height;
+    opt_levels = header->levels;
+    // keyframes are only ever read; the pointers just aren't const
+    glob_cache = (uint8_t *)map;
+    return true;
 }
 
 // finished computation, swap buffers
@@ -209,25 +659,12 @@ void zoomFractal( double z, uint8_t pixels[] ) {
         startx = ((opt_width<<17)-width)>>1,
         starty = ((opt_height<<17)-height)>>1,
         deltax = width / opt_width,
-        deltay = height / opt_height,
-        px, py = starty;
-    long glob_offs = 0;
-    for (int j=0; j < opt_height; j++) {
-        px = startx;
-        for (int i=0; i < opt_width; i++) {
-            // bilinear filter
-            pixels[glob_offs] =
-                ( glob_frac2[(py>>16)*(opt_width * 2)+(px>>16)] * (0x100-((py>>8)&0xff)) * (0x100-((px>>8)&0xff))
-                + glob_frac2[(py>>16)*(opt_width * 2)+((px>>16)+1)] * (0x100-((py>>8)&0xff)) * ((px>>8)&0xff)
-                + glob_frac2[((py>>16)+1)*(opt_width * 2)+(px>>16)] * ((py>>8)&0xff) * (0x100-((px>>8)&0xff))
-                + glob_frac2[((py>>16)+1)*(opt_width * 2)+((px>>16)+1)] * ((py>>8)&0xff) * ((px>>8)&0xff) ) >> 16;
-            // interpolate X
-            px += deltax;
-            glob_offs++;
-        }
-        // interpolate Y
-        py += deltay;
-    }
+        deltay = height / opt_height;
+
+    // bilinear filter
+    glob_scaler.SetColumns(opt_width, startx, deltax);
+    glob_scaler.SetRows(opt_height, starty, deltay);
+    glob_scaler.Scale(glob_frac2, opt_width * 2, pixels, opt_width);
 }
 
 void updatePalette(int t, Color palette[]) {
@@ -254,6 +691,47 @@ void updatePalette(int t, Color palette[]) {
 }
 
 
+// --------------------------------------------------------------------------------
+// Julia mode
+//
+// Instead of zooming, the c of a Julia set moves around a circle, so every
+// frame is a whole new fractal computed by all threads.
+
+void juliaLoop(UDPFlaschenTaschen &canvas, Color palette[]) {
+    const double zy = JULIA_VIEW, zx = zy * opt_width / opt_height;
+    const int w = opt_width * 2;
+    const time_t starttime = time(NULL);
+    FrameTimer timer(opt_delay);
+    double angle = 0;
+    long long frameCount = 0;
+
+    do {
+        timer.Start();
+        angle += timer.period() * JULIA_SPEED;
+        glob_julia = Julia(JULIA_RADIUS * cos(angle), JULIA_RADIUS * sin(angle));
+        startFractal( zx, zy );
+        waitFractal();
+
+        // average the colors of each 2x2 block
+        updatePalette( frameCount, palette );
+        for (int y=0; y < opt_height; y++) {
+            const uint8_t *row = glob_frac1 + (long)y * 2 * w;
+            for (int x=0; x < opt_width; x++) {
+                const Color &a = palette[ row[2*x] ], &b = palette[ row[2*x + 1] ];
+                const Color &c = palette[ row[w + 2*x] ], &d = palette[ row[w + 2*x + 1] ];
+                canvas.SetPixel( x, y, Color((a.r + b.r + c.r + d.r) / 4,
+                                             (a.g + b.g + c.g + d.g) / 4,
+                                             (a.b + b.b + c.b + d.b) / 4) );
+            }
+        }
+        canvas.SetOffset(opt_xoff + DISPLAY_XOFF, opt_yoff + DISPLAY_YOFF, opt_layer);
+        canvas.Send();
+
+        timer.Sleep();
+        frameCount++;
+    } while ( (difftime(time(NULL), starttime) <= opt_timeout) && !interrupt_received );
+}
+
 // --------------------------------------------------------------------------------
 // Main
 
@@ -261,11 +739,7 @@ int main(int argc, char *argv[]) {
 
     // parse command line
     if (int e = cmdLine(argc, argv)) { return e; }
-
-    // open socket and create our canvas
-    const int socket = OpenFlaschenTaschenSocket(opt_hostname);
-    UDPFlaschenTaschen canvas(socket, opt_width, opt_height);
-    canvas.Clear();
+    if (opt_playback && !openZoomCache(opt_playback)) { return 1; }
 
     // init vars
     Color palette[256];
@@ -278,16 +752,61 @@ int main(int argc, char *argv[]) {
     // allocate memory for our fractal
     //glob_frac1 = new uint8_t[640 * 400];
     //glob_frac2 = new uint8_t[640 * 400];
-    glob_frac1 = new uint8_t[opt_width * opt_height * 4];
-    glob_frac2 = new uint8_t[opt_width * opt_height * 4];
+    uint8_t *frac1 = NULL, *frac2 = NULL;
+    if (!glob_cache) {
+        frac1 = glob_frac1 = new uint8_t[opt_width * opt_height * 4];
+        frac2 = glob_frac2 = new uint8_t[opt_width * opt_height * 4];
+    }
+    glob_cr = new double[opt_width * 2 + LANES];
+    glob_pool = new ThreadPool(glob_cache ? 0 : opt_threads);
+
+    // levels to zoom in before reversing, may change every cycle
+    int levels = opt_levels;
+    if (opt_auto && !glob_cache) {
+        srandom(time(NULL));
+        levels = findTarget(opt_levels);
+        if (opt_record) { opt_levels = levels; }
+    }
+
+    if (opt_record) {
+        signal(SIGTERM, InterruptHandler);
+        signal(SIGINT, InterruptHandler);
+        int e = recordZoom(opt_record);
+        delete glob_pool;
+        delete [] frac1;
+        delete [] frac2;
+        delete [] glob_cr;
+        return e;
+    }
+
+    // open socket and create our canvas
+    const int socket = OpenFlaschenTaschenSocket(opt_hostname);
+    UDPFlaschenTaschen canvas(socket, opt_width, opt_height);
+    canvas.Clear();
+
+    if (opt_formula == FORMULA_JULIA) {
+        // centered on the origin, unless given a point
+        if (!opt_point) { glob_point_r = glob_point_i = Fixed(); }
+        signal(SIGTERM, InterruptHandler);
+        signal(SIGINT, InterruptHandler);
+        juliaLoop(canvas, palette);
+
+        canvas.Clear();
+        canvas.Send();
+        delete glob_pool;
+        delete [] frac1;
+        delete [] frac2;
+        delete [] glob_cr;
+        return interrupt_received ? 1 : 0;
+    }
 
     // set original zooming settings
     double zx = 4.0, zy = 4.0;
     bool zoom_in = true;
     // calculate the first fractal
     //printf("Calculating first frame... ");
-    startFractal( POINT_OR - zx, POINT_OI - zy, POINT_OR + zx, POINT_OI + zy );
-    for (int j=0; j < 100; j++) { computeFractal(); }
+    startFractal( zx, zy );
+    waitFractal();
     finishFractal();
     //printf("done\n");
     
@@ -300,32 +819,47 @@ int main(int argc, char *argv[]) {
 
     time_t starttime = time(NULL);
 
+    // Each frame, the next fractal gets computed for whatever time is left
+    // after displaying. The zoom starts at the old pace of one frame per
+    // computed row, then speeds up (down to opt_zoom_time per level) while
+    // the next fractal is ready early, and slows down again (no further than
+    // that first pace) if it isn't.
+    FrameTimer timer(opt_delay);
+    const double max_zoom_time = fmax(opt_zoom_time, opt_height * 2 * opt_delay / 1000.0);
+    double zoom_time = max_zoom_time;
+    int64_t row_usec = 0;   // how long a row takes, on average
+
     do {
         // adjust zooming coefficient for next view
         if (zoom_in) { zx *= 0.5; zy *= 0.5; }
         else { zx *= 2; zy *= 2; }
 
         // start calculating the next fractal
-        startFractal( POINT_OR - zx, POINT_OI - zy, POINT_OR + zx, POINT_OI + zy );
-        int j=0;
-        //while (j < 100) {
-        while (j < (opt_height * 2)) {
-            j++;
-            // calc another few lines
-            computeFractal();
+        startFractal( zx, zy );
+        double t = 0;          // how far into the old fractal we've zoomed, 0 to 1
+        double t_ready = -1;   // and how far when the next one was ready
+        bool stalled = false;
+        bool first = true;     // the next fractal has only just been started
+        while (t < 1.0 && !interrupt_received) {
+            timer.Start();
+
+            // advance the zoom by the time that passed, but not beyond the
+            // part of the next fractal that has been computed. It only counts
+            // as held back once the zoom is at the end, or has caught up
+            // with the computation after the first frame.
+            const double want = t + timer.period() / zoom_time;
+            const double ready = readyFractal();
+            if (ready < 1.0 && want > ready && (want >= 1.0 || !first)) { stalled = true; }
+            t = fmin(1.0, fmin(want, ready));
+            if (t_ready < 0 && ready >= 1.0) { t_ready = t; }
+            first = false;
 
             // display the old fractal, zooming in or out
-            //if (zoom_in) { zoomFractal( (double)j / 100.0f ); }
-            //else { zoomFractal( 1.0f - (double)j / 100.0f ); }
-            if (zoom_in) { zoomFractal( (double)j / (opt_height * 2), pixels ); }
-            else { zoomFractal( 1.0f - (double)j / (opt_height * 2), pixels ); }
+            if (zoom_in) { zoomFractal( t, pixels ); }
+            else { zoomFractal( 1.0f - t, pixels ); }
 
             // select some new colours
-            //updatePalette( k * 100 + j );
-            updatePalette( k * (opt_height * 2) + j, palette );
-
-            // dump to screen
-            //vga->Update();
+            updatePalette( frameCount + 1, palette );
 
             // copy pixel buffer to canvas
             int dst = 0;
@@ -339,21 +873,45 @@ int main(int argc, char *argv[]) {
             // send canvas
             canvas.SetOffset(opt_xoff + DISPLAY_XOFF, opt_yoff + DISPLAY_YOFF, opt_layer);
             canvas.Send();
-            usleep(opt_delay * 1000);
+
+            // lend a hand with the next fractal until the frame is over
+            while (timer.HasTime(row_usec)) {
+                const int64_t start = nowMicros();
+                if (!glob_pool->RunOne()) break;
+                row_usec = (row_usec * 7 + (nowMicros() - start)) / 8;
+            }
+            timer.Sleep();
 
             frameCount++;
         }
+
+        // adapt the zoom speed to how long the fractal took
+        if (stalled) { zoom_time = fmin(max_zoom_time, zoom_time * 1.1); }
+        else if (t_ready >= 0 && t_ready < 0.5) { zoom_time = fmax(opt_zoom_time, zoom_time * 0.9); }
+
+        // make sure the next fractal is complete
+        waitFractal();
+
         // one more image displayed
         k++;
         // check if we've gone far enough
-        if (k % 38 == 0) {
+        if (k == levels) {
             // if so, reverse direction
+            k = 0;
             zoom_in = !zoom_in;
             if (zoom_in) { zx *= 0.5; zy *= 0.5; }
             else { zx *= 2.0; zy *= 2.0; }
 
             // and make sure we use the same fractal again, in the other direction
             finishFractal();
+
+            if (zoom_in && opt_auto && !glob_cache) {
+                // back at the top: head somewhere new
+                // the swap below makes its first view the one displayed
+                levels = findTarget(opt_levels);
+                startFractal( zx, zy );
+                waitFractal();
+            }
         }
         finishFractal();
 
@@ -366,8 +924,11 @@ int main(int argc, char *argv[]) {
     canvas.Clear();
     canvas.Send();
 
-    delete glob_frac1;
-    delete glob_frac2;
+    delete glob_pool;
+    delete [] frac1;
+    delete [] frac2;
+    delete [] glob_cr;
+    if (glob_cache) munmap(glob_cache, glob_cache_size);
 
     if (interrupt_received) return 1;
     return 0;
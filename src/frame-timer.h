@@ -0,0 +1,80 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// frame-timer.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Keeps a steady frame rate while using the rest of each frame for work.
+// Instead of computing a fixed amount and then sleeping the full delay,
+// a demo starts the timer at the top of each frame, does its optional work
+// while HasTime() says it still fits, then sleeps whatever is left:
+//
+//  FrameTimer timer(opt_delay);
+//  do {
+//      timer.Start();
+//      ... draw & send ...
+//      while (timer.HasTime(step_usec)) { ... one step of work ... }
+//      timer.Sleep();
+//  } while (...);
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef FRAME_TIMER_H
+#define FRAME_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+// monotonic clock in microseconds
+static inline int64_t nowMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+class FrameTimer {
+public:
+    explicit FrameTimer(int delay_ms) : delay_(delay_ms * 1000), start_(0), period_(0) {}
+
+    // beginning of a new frame
+    void Start() {
+        const int64_t now = nowMicros();
+        period_ = (start_ == 0) ? delay_ : now - start_;
+        start_ = now;
+    }
+
+    // time left until the end of this frame
+    int64_t Remaining() const { return start_ + delay_ - nowMicros(); }
+
+    // true if something taking 'usec' still fits into this frame
+    bool HasTime(int64_t usec) const { return Remaining() > usec; }
+
+    // sleep until the end of this frame
+    void Sleep() const {
+        const int64_t left = Remaining();
+        if (left > 0) usleep(left);
+    }
+
+    // actual time between the last two frames, in seconds
+    double period() const { return period_ / 1e6; }
+
+private:
+    const int64_t delay_;
+    int64_t start_;
+    int64_t period_;
+};
+
+#endif  // FRAME_TIMER_H
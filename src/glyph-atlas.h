@@ -0,0 +1,98 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// glyph-atlas.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Glyphs of a BDF font, drawn once into 8-bit alpha bitmaps so they can be
+// copied onto a pixel buffer every frame without going through the font
+// again. All glyphs get a cell of the same size: as wide as the widest
+// one, and the font's height, with the baseline where the font has it.
+//
+// Usage:
+//
+//  GlyphAtlas atlas;
+//  atlas.Build(font, codepoints, count);
+//  const uint8_t *alpha = atlas.Glyph(i);   // atlas.width() x atlas.height()
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include "bdf-font.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+class GlyphAtlas {
+public:
+    GlyphAtlas() : width_(0), height_(0) {}
+
+    // Draw the glyphs the font has of 'codepoints'. False if it has none.
+    bool Build(const ft::Font &font, const uint32_t *codepoints, int count) {
+        width_ = 0;
+        height_ = font.height();
+        codepoints_.clear();
+        for (int i=0; i < count; i++) {
+            const int w = font.CharacterWidth(codepoints[i]);
+            if (w <= 0) continue;
+            codepoints_.push_back(codepoints[i]);
+            if (w > width_) width_ = w;
+        }
+        if (codepoints_.empty() || height_ <= 0) return false;
+
+        alpha_.assign(codepoints_.size() * width_ * height_, 0);
+        for (size_t i=0; i < codepoints_.size(); i++) {
+            AlphaCanvas canvas(width_, height_, &alpha_[i * width_ * height_]);
+            // centered in the cell
+            const int x = (width_ - font.CharacterWidth(codepoints_[i])) / 2;
+            font.DrawGlyph(&canvas, x, font.baseline(), Color(255, 255, 255), NULL, codepoints_[i]);
+        }
+        return true;
+    }
+
+    int count() const { return codepoints_.size(); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // width() x height() alpha values of glyph i, row by row
+    const uint8_t *Glyph(int i) const { return &alpha_[i * width_ * height_]; }
+
+private:
+    // the font draws into one cell of the atlas through this
+    class AlphaCanvas : public FlaschenTaschen {
+    public:
+        AlphaCanvas(int width, int height, uint8_t *alpha)
+            : width_(width), height_(height), alpha_(alpha) {}
+        virtual int width() const { return width_; }
+        virtual int height() const { return height_; }
+        virtual void SetPixel(int x, int y, const Color &col) {
+            if (x < 0 || x >= width_ || y < 0 || y >= height_) return;
+            alpha_[y * width_ + x] = col.is_black() ? 0 : 255;
+        }
+        virtual void Send() {}
+    private:
+        const int width_, height_;
+        uint8_t *const alpha_;
+    };
+
+    int width_, height_;            // of a cell
+    std::vector<uint32_t> codepoints_;
+    std::vector<uint8_t> alpha_;    // count() cells
+};
+
+#endif  // GLYPH_ATLAS_H
@@ -40,6 +40,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "hack_font.h"
+#include "blur-kernels.h"
 #include "config.h"
 
 #include <getopt.h>
@@ -291,15 +292,8 @@ void drawRandomLine(int width, int height, uint8_t pixels[]) {
 
 void blur(int width, int height, uint8_t pixels[]) {
     
-    int size = width * (height - 1) - 1;
-    uint8_t dot;
     // blur effect
-    for (int i=0; i < size; i++) {
-        dot = (uint8_t)((pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) >> 2) & 0xFF;
-        if (dot <= BLUR_DROP) { dot = 0; }
-        else { dot -= BLUR_DROP; }
-        pixels[i] = dot;
-    }
+    blurBox(pixels, width * (height - 1) - 1, width, BLUR_DROP);
 }
 
 void drawHackChar(int charcode, int angle, uint8_t color, int width, int height, uint8_t pixels[]) {
@@ -0,0 +1,108 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// hashlife-test
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Checks what HashLife shows on the display at every zoom: patterns of
+// known cells are set, on both sides of the origin and from a few cells
+// across to far more than the display, and every pixel must be lit exactly
+// when one of the cells it covers was set.
+//
+//  ./hashlife-test
+//
+// --------------------------------------------------------------------------------
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#include "hashlife.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define WIDTH 45
+#define HEIGHT 35
+#define MAX_ZOOM 12
+#define CELLS 40   // random cells per pattern
+
+struct Cell {
+    int64_t x, y;
+};
+
+// the display as it should look, from the cells themselves
+void expected(const std::vector<Cell> &cells, int zoom, std::vector<bool> &lit) {
+    lit.assign(WIDTH * HEIGHT, false);
+    for (size_t i=0; i < cells.size(); i++) {
+        // floor division, so cells left of or above the origin land right
+        const int64_t px = (cells[i].x >= 0 ? cells[i].x : cells[i].x - ((1LL << zoom) - 1)) / (1LL << zoom);
+        const int64_t py = (cells[i].y >= 0 ? cells[i].y : cells[i].y - ((1LL << zoom) - 1)) / (1LL << zoom);
+        const int64_t x = px + WIDTH / 2, y = py + HEIGHT / 2;
+        if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) { lit[y * WIDTH + x] = true; }
+    }
+}
+
+// returns how many pixels were wrong
+int check(const char *name, const std::vector<Cell> &cells) {
+    HashLife life(WIDTH, HEIGHT);
+    for (size_t i=0; i < cells.size(); i++) { life.SetCell(cells[i].x, cells[i].y, true); }
+    int wrong = 0;
+    std::vector<bool> lit;
+    for (int zoom=0; zoom <= MAX_ZOOM; zoom++) {
+        life.SetZoom(zoom);
+        expected(cells, zoom, lit);
+        for (int y=0; y < HEIGHT; y++) {
+            for (int x=0; x < WIDTH; x++) {
+                if (life.Get(x, y) == lit[y * WIDTH + x]) continue;
+                if (wrong < 10) {
+                    fprintf(stderr, "%s: pixel %d,%d at zoom %d should be %s\n",
+                            name, x, y, zoom, lit[y * WIDTH + x] ? "lit" : "dark");
+                }
+                wrong++;
+            }
+        }
+    }
+    return wrong;
+}
+
+int main(int argc, char *argv[]) {
+
+    srandom(1);
+    int failed = 0, tests = 0;
+
+    // a glider up and left of the origin
+    const Cell glider[] = { { -5, -7 }, { -4, -6 }, { -6, -5 }, { -5, -5 }, { -4, -5 } };
+    failed += check("glider", std::vector<Cell>(glider, glider + 5)) > 0;
+    tests++;
+
+    // random cells spread over squares from 4 to 2^16 cells across
+    for (int spread=2; spread <= 16; spread++) {
+        for (int run=0; run < 4; run++) {
+            std::vector<Cell> cells(CELLS);
+            const int64_t side = 1LL << spread;
+            for (int i=0; i < CELLS; i++) {
+                cells[i].x = (int64_t)(random() % side) - side / 2;
+                cells[i].y = (int64_t)(random() % side) - side / 2;
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "spread %d", spread);
+            failed += check(name, cells) > 0;
+            tests++;
+        }
+    }
+    printf("%d of %d patterns show right at zoom 0-%d\n", tests - failed, tests, MAX_ZOOM);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,342 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// hashlife.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Bill Gosper's HashLife: the Game of Life on an unbounded universe that
+// can jump ahead 2^n generations at a time.
+//
+// The universe is a quadtree. A node of level k is a 2^k x 2^k square made
+// of four level k-1 nodes; level 0 nodes are single cells. Nodes are
+// canonical (looked up in a hash table before being created), so any
+// square that shows up twice is the same node, and the result of running
+// a node - its center 2^(k-1) square some generations later - is
+// remembered in the node. Repetitive patterns then cost next to nothing,
+// no matter how large or how far ahead.
+//
+// Nodes live in one arena and refer to each other by index. When the arena
+// gets too big, everything not reachable from the current universe is
+// thrown away.
+//
+// The display shows a window centered on the origin, with each display
+// pixel covering 2^zoom x 2^zoom cells (lit if any of them is alive).
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include "life-engine.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define HASHLIFE_MAX_NODES (1 << 21)  // garbage collect beyond this many nodes
+#define HASHLIFE_MAX_LEVEL 60         // universe coordinates must fit 64 bits
+
+class HashLife : public LifeEngine {
+public:
+    HashLife(int width, int height) : width_(width), height_(height), step_log_(0), zoom_(0) {
+        Reset();
+    }
+
+    // each Run() advances 2^n generations
+    void SetStepLog(int n) {
+        if (n == step_log_) return;
+        step_log_ = n;
+        // remembered results are for the old step size
+        for (size_t i=0; i < nodes_.size(); i++) { nodes_[i].result = NONE; }
+    }
+
+    // each display pixel shows 2^z x 2^z cells
+    void SetZoom(int z) { zoom_ = z; }
+
+    long long generation() const { return generation_; }
+    size_t nodes() const { return nodes_.size(); }
+
+    virtual void Clear() { Reset(); }
+
+    // one cell per pixel, as if at zoom 0, so a display full of cells
+    // stays the same pattern whatever the zoom
+    virtual void Set(int x, int y, bool alive) {
+        SetCell(x - width_ / 2, y - height_ / 2, alive);
+    }
+
+    virtual bool Get(int x, int y) const {
+        const int64_t scale = (int64_t)1 << zoom_;
+        return Live(((int64_t)x - width_ / 2) * scale, ((int64_t)y - height_ / 2) * scale, zoom_);
+    }
+
+    // of the display only, the universe beyond it doesn't show anyway
+    virtual uint64_t Hash() const {
+        uint64_t h = 0;
+        for (int y=0; y < height_; y++) {
+            for (int x=0; x < width_; x++) {
+                // FNV-1a, except it starts from 0 so an empty display is 0
+                h = (h ^ Get(x, y)) * 0x100000001b3ULL;
+            }
+        }
+        return h;
+    }
+
+    virtual void Run() {
+        if (nodes_.size() > HASHLIFE_MAX_NODES) { Collect(); }
+        // The result of a level k node is its center, 2^(k-2) generations
+        // on at most. Grow until everything alive is in the center quarter,
+        // the step fits, and then once more so there's room to move into.
+        while (Level(root_) < step_log_ + 2 || !Centered(root_)) {
+            if (Level(root_) >= HASHLIFE_MAX_LEVEL) return;
+            Expand();
+        }
+        Expand();
+        root_ = Result(root_);
+        generation_ += 1LL << step_log_;
+    }
+
+    // cell at universe coordinates, the origin is in the display center
+    void SetCell(int64_t x, int64_t y, bool alive) {
+        while (!Inside(x, y, Level(root_))) {
+            if (Level(root_) >= HASHLIFE_MAX_LEVEL) return;
+            Expand();
+        }
+        const int64_t half = 1LL << (Level(root_) - 1);
+        root_ = SetRec(root_, x + half, y + half, alive);
+    }
+
+private:
+    enum { NONE = 0xffffffffu };   // no node
+
+    struct Node {
+        uint32_t nw, ne, sw, se;    // children
+        uint32_t next;              // hash chain
+        uint32_t result;            // center after running, or NONE
+        int level;
+        bool live;                  // anything alive in here
+    };
+
+    int Level(uint32_t n) const { return nodes_[n].level; }
+
+    static bool Inside(int64_t x, int64_t y, int level) {
+        const int64_t half = 1LL << (level - 1);
+        return x >= -half && x < half && y >= -half && y < half;
+    }
+
+    void Reset() {
+        nodes_.clear();
+        const Node dead = { 0, 0, 0, 0, NONE, NONE, 0, false };
+        const Node alive = { 0, 0, 0, 0, NONE, NONE, 0, true };
+        nodes_.push_back(dead);
+        nodes_.push_back(alive);
+        buckets_.assign(1 << 16, NONE);
+        empty_.assign(1, 0);
+        root_ = Empty(3);
+        generation_ = 0;
+    }
+
+    // the canonical node with these children
+    uint32_t Find(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+        const size_t mask = buckets_.size() - 1;
+        const size_t h = Hash(nw, ne, sw, se) & mask;
+        for (uint32_t n = buckets_[h]; n != NONE; n = nodes_[n].next) {
+            const Node &node = nodes_[n];
+            if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se) return n;
+        }
+        const bool live = nodes_[nw].live || nodes_[ne].live || nodes_[sw].live || nodes_[se].live;
+        const Node node = { nw, ne, sw, se, buckets_[h], NONE, nodes_[nw].level + 1, live };
+        const uint32_t n = nodes_.size();
+        nodes_.push_back(node);
+        buckets_[h] = n;
+        if (nodes_.size() > buckets_.size()) { Rehash(buckets_.size() * 2); }
+        return n;
+    }
+
+    static size_t Hash(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+        uint64_t h = nw;
+        h = h * 0x9E3779B97F4A7C15ULL + ne;
+        h = h * 0x9E3779B97F4A7C15ULL + sw;
+        h = h * 0x9E3779B97F4A7C15ULL + se;
+        return (size_t)(h ^ (h >> 29));
+    }
+
+    void Rehash(size_t size) {
+        buckets_.assign(size, NONE);
+        for (uint32_t n=0; n < nodes_.size(); n++) {
+            Node &node = nodes_[n];
+            if (node.level == 0) continue;
+            const size_t h = Hash(node.nw, node.ne, node.sw, node.se) & (size - 1);
+            node.next = buckets_[h];
+            buckets_[h] = n;
+        }
+    }
+
+    // the empty node of a level
+    uint32_t Empty(int level) {
+        while ((int)empty_.size() <= level) {
+            const uint32_t e = empty_.back();
+            empty_.push_back(Find(e, e, e, e));
+        }
+        return empty_[level];
+    }
+
+    // double the universe around its center
+    void Expand() {
+        const Node r = nodes_[root_];
+        const uint32_t e = Empty(r.level - 1);
+        const uint32_t nw = Find(e, e, e, r.nw);
+        const uint32_t ne = Find(e, e, r.ne, e);
+        const uint32_t sw = Find(e, r.sw, e, e);
+        const uint32_t se = Find(r.se, e, e, e);
+        root_ = Find(nw, ne, sw, se);
+    }
+
+    // everything alive is inside the center quarter
+    bool Centered(uint32_t n) const {
+        const Node &r = nodes_[n];
+        const Node &nw = nodes_[r.nw], &ne = nodes_[r.ne], &sw = nodes_[r.sw], &se = nodes_[r.se];
+        return !(nodes_[nw.nw].live || nodes_[nw.ne].live || nodes_[nw.sw].live
+                 || nodes_[ne.nw].live || nodes_[ne.ne].live || nodes_[ne.se].live
+                 || nodes_[sw.nw].live || nodes_[sw.sw].live || nodes_[sw.se].live
+                 || nodes_[se.ne].live || nodes_[se.sw].live || nodes_[se.se].live);
+    }
+
+    // x,y relative to the top left of node n
+    uint32_t SetRec(uint32_t n, int64_t x, int64_t y, bool alive) {
+        const Node node = nodes_[n];
+        if (node.level == 0) return alive ? 1 : 0;
+        const int64_t half = 1LL << (node.level - 1);
+        if (y < half) {
+            if (x < half) return Find(SetRec(node.nw, x, y, alive), node.ne, node.sw, node.se);
+            return Find(node.nw, SetRec(node.ne, x - half, y, alive), node.sw, node.se);
+        }
+        if (x < half) return Find(node.nw, node.ne, SetRec(node.sw, x, y - half, alive), node.se);
+        return Find(node.nw, node.ne, node.sw, SetRec(node.se, x - half, y - half, alive));
+    }
+
+    // anything alive in the 2^level square at universe x,y
+    bool Live(int64_t x, int64_t y, int level) const {
+        const int64_t half = 1LL << (Level(root_) - 1);
+        return LiveIn(root_, -half, -half, x, y, level);
+    }
+
+    // Anything alive where node n, top left at universe nx,ny, overlaps the
+    // 2^level square at x,y. Below the root, nodes are on a grid of their
+    // own size, so a node either holds the square, is inside it, or misses
+    // it. The root is centered on the origin and may straddle squares.
+    bool LiveIn(uint32_t n, int64_t nx, int64_t ny, int64_t x, int64_t y, int level) const {
+        const Node &node = nodes_[n];
+        if (!node.live) return false;
+        const int64_t size = 1LL << node.level, side = 1LL << level;
+        if (x >= nx + size || x + side <= nx || y >= ny + size || y + side <= ny) return false;
+        if (x <= nx && y <= ny && x + side >= nx + size && y + side >= ny + size) return true;
+        const int64_t h = size / 2;
+        return LiveIn(node.nw, nx, ny, x, y, level) || LiveIn(node.ne, nx + h, ny, x, y, level)
+            || LiveIn(node.sw, nx, ny + h, x, y, level) || LiveIn(node.se, nx + h, ny + h, x, y, level);
+    }
+
+    // center quarter of a node
+    uint32_t Center(uint32_t n) {
+        const Node node = nodes_[n];
+        return Find(nodes_[node.nw].se, nodes_[node.ne].sw, nodes_[node.sw].ne, nodes_[node.se].nw);
+    }
+
+    // Center of a level k node after 2^j generations, j = min(step_log_, k-2).
+    // Nine overlapping level k-1 squares are either run or just centered,
+    // then combined into four that are run again.
+    uint32_t Result(uint32_t n) {
+        const Node node = nodes_[n];
+        if (!node.live) return Empty(node.level - 1);
+        if (node.result != NONE) return node.result;
+
+        uint32_t r;
+        if (node.level == 2) {
+            r = Base(node);
+        } else {
+            const Node nw = nodes_[node.nw], ne = nodes_[node.ne];
+            const Node sw = nodes_[node.sw], se = nodes_[node.se];
+            uint32_t m[9] = {
+                node.nw, Find(nw.ne, ne.nw, nw.se, ne.sw), node.ne,
+                Find(nw.sw, nw.se, sw.nw, sw.ne), Find(nw.se, ne.sw, sw.ne, se.nw), Find(ne.sw, ne.se, se.nw, se.ne),
+                node.sw, Find(sw.ne, se.nw, sw.se, se.sw), node.se
+            };
+            // full speed runs both halves, otherwise only the second one
+            const bool full = step_log_ >= node.level - 2;
+            for (int i=0; i < 9; i++) { m[i] = full ? Result(m[i]) : Center(m[i]); }
+            r = Find(Result(Find(m[0], m[1], m[3], m[4])), Result(Find(m[1], m[2], m[4], m[5])),
+                     Result(Find(m[3], m[4], m[6], m[7])), Result(Find(m[4], m[5], m[7], m[8])));
+        }
+        nodes_[n].result = r;
+        return r;
+    }
+
+    // one generation of the center 2x2 of a 4x4 node, cell by cell
+    uint32_t Base(const Node &node) {
+        int cell[4][4];
+        const uint32_t quad[4] = { node.nw, node.ne, node.sw, node.se };
+        for (int q=0; q < 4; q++) {
+            const Node &c = nodes_[quad[q]];
+            const int x = (q & 1) * 2, y = (q >> 1) * 2;
+            cell[y][x] = c.nw; cell[y][x + 1] = c.ne;
+            cell[y + 1][x] = c.sw; cell[y + 1][x + 1] = c.se;
+        }
+        uint32_t out[4];
+        for (int i=0; i < 4; i++) {
+            const int x = 1 + (i & 1), y = 1 + (i >> 1);
+            int count = 0;
+            for (int dy=-1; dy <= 1; dy++) {
+                for (int dx=-1; dx <= 1; dx++) {
+                    if (dx || dy) { count += cell[y + dy][x + dx]; }
+                }
+            }
+            out[i] = (count == 3 || (count == 2 && cell[y][x])) ? 1 : 0;
+        }
+        return Find(out[0], out[1], out[2], out[3]);
+    }
+
+    // throw away all nodes that aren't part of the current universe
+    void Collect() {
+        std::vector<Node> old;
+        old.swap(nodes_);
+        const uint32_t root = root_;
+        const long long generation = generation_;
+        Reset();
+        generation_ = generation;
+        std::vector<uint32_t> moved(old.size(), NONE);
+        moved[0] = 0;
+        moved[1] = 1;
+        root_ = Copy(old, moved, root);
+    }
+
+    uint32_t Copy(const std::vector<Node> &old, std::vector<uint32_t> &moved, uint32_t n) {
+        if (moved[n] == NONE) {
+            const Node &node = old[n];
+            moved[n] = Find(Copy(old, moved, node.nw), Copy(old, moved, node.ne),
+                            Copy(old, moved, node.sw), Copy(old, moved, node.se));
+        }
+        return moved[n];
+    }
+
+    int width_, height_;
+    int step_log_;
+    int zoom_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> buckets_;   // hash table of nodes, chained through Node::next
+    std::vector<uint32_t> empty_;     // empty node of each level
+    uint32_t root_;
+    long long generation_;
+};
+
+#endif  // HASHLIFE_H
@@ -0,0 +1,238 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// ifs.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Iterated function systems, drawn with the chaos game: a point jumps
+// around by randomly picked affine maps, and wherever it lands is part of
+// the fractal. Each map is
+//
+//   x' = a x + b y + e
+//   y' = c x + d y + f
+//
+// picked with probability p. Ifs::Parse() takes one of the built in
+// systems (sierpinski, fern, dragon), or maps written as "a,b,c,d,e,f[,p]"
+// separated by ';'. Without p, maps are picked by how much area they cover.
+//
+// IfsRenderer counts how often each pixel is landed on. Every thread runs
+// its own points into its own histogram, which are then added together,
+// and the counts are shown by log density, so that both the thin and the
+// busy parts of the fractal show up.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef IFS_H
+#define IFS_H
+
+#include "thread-pool.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define IFS_MAX_MAPS 32
+
+struct IfsMap {
+    float a, b, c, d, e, f;
+    float p;
+};
+
+struct Ifs {
+    // False if 'spec' is neither a known name nor a list of maps.
+    bool Parse(const char *spec) {
+        static const struct {
+            const char *name;
+            const char *maps;
+        } kBuiltIn[] = {
+            // the original demo's triangle, corners at (0.5,1), (0,0) and (1,0)
+            { "sierpinski", "0.5,0,0,0.5,0.25,0.5;0.5,0,0,0.5,0,0;0.5,0,0,0.5,0.5,0" },
+            { "fern", "0,0,0,0.16,0,0,0.01;0.85,0.04,-0.04,0.85,0,1.6,0.85;"
+                      "0.2,-0.26,0.23,0.22,0,1.6,0.07;-0.15,0.28,0.26,0.24,0,0.44,0.07" },
+            { "dragon", "0.5,-0.5,0.5,0.5,0,0;-0.5,-0.5,0.5,-0.5,1,0" },
+        };
+        for (size_t i=0; i < sizeof(kBuiltIn) / sizeof(kBuiltIn[0]); i++) {
+            if (strcmp(spec, kBuiltIn[i].name) == 0) return Parse(kBuiltIn[i].maps);
+        }
+
+        maps.clear();
+        for (const char *p = spec; *p; ) {
+            IfsMap m;
+            int len = 0;
+            const int n = sscanf(p, "%f,%f,%f,%f,%f,%f%n,%f%n",
+                                 &m.a, &m.b, &m.c, &m.d, &m.e, &m.f, &len, &m.p, &len);
+            if (n < 6 || maps.size() == IFS_MAX_MAPS) return false;
+            if (n == 6) m.p = fabsf(m.a * m.d - m.b * m.c) + 0.01f;
+            if (m.p < 0) return false;
+            maps.push_back(m);
+            p += len;
+            if (*p == ';') {
+                p++;
+            } else if (*p) {
+                return false;
+            }
+        }
+        float sum = 0;
+        for (size_t i=0; i < maps.size(); i++) { sum += maps[i].p; }
+        return sum > 0;
+    }
+
+    std::vector<IfsMap> maps;
+};
+
+class IfsRenderer {
+public:
+    // 'pool' may be NULL to run on the calling thread only
+    IfsRenderer(int width, int height, const Ifs &ifs, ThreadPool *pool)
+        : width_(width), height_(height), maps_(ifs.maps), pool_(pool),
+          hits_(width * height, 0), row_max_(height, 0) {
+        // pick a map by comparing 32 random bits against these
+        float sum = 0, cum = 0;
+        for (size_t i=0; i < maps_.size(); i++) { sum += maps_[i].p; }
+        for (size_t i=0; i + 1 < maps_.size(); i++) {
+            cum += maps_[i].p;
+            threshold_[i] = (uint32_t)(cum / sum * 4294967295.0);
+        }
+        Fit();
+        threads_.resize(pool_ ? pool_->size() + 1 : 1);
+        for (size_t i=0; i < threads_.size(); i++) {
+            threads_[i].hits.assign(width * height, 0);
+            threads_[i].rng = 0x9E3779B97F4A7C15ULL * (i + 1) ^ (uint64_t)random();
+            threads_[i].x = threads_[i].y = 0;
+            // settle onto the fractal before anything is counted
+            for (int k=0; k < 32; k++) { Jump(threads_[i]); }
+        }
+    }
+
+    void Clear() {
+        memset(&hits_[0], 0, hits_.size() * sizeof(uint32_t));
+        memset(&row_max_[0], 0, row_max_.size() * sizeof(uint32_t));
+    }
+
+    // Play the chaos game for 'points' more points, spread over the threads.
+    void Render(int points) {
+        const int n = threads_.size();
+        Run(n, [this, points, n](int i) {
+                Thread &t = threads_[i];
+                const int count = points / n + (i < points % n);
+                for (int k=0; k < count; k++) {
+                    Jump(t);
+                    const int px = (int)(t.x * scale_x_ + offset_x_);
+                    const int py = (int)(t.y * scale_y_ + offset_y_);
+                    if ((unsigned)px < (unsigned)width_ && (unsigned)py < (unsigned)height_) {
+                        t.hits[py * width_ + px]++;
+                    }
+                }
+            });
+        // add up the threads' histograms, a row at a time
+        Run(height_, [this](int y) {
+                uint32_t *row = &hits_[y * width_];
+                uint32_t max = 0;
+                for (size_t i=0; i < threads_.size(); i++) {
+                    uint32_t *hits = &threads_[i].hits[y * width_];
+                    for (int x=0; x < width_; x++) {
+                        row[x] += hits[x];
+                        hits[x] = 0;
+                    }
+                }
+                for (int x=0; x < width_; x++) { if (row[x] > max) max = row[x]; }
+                row_max_[y] = max;
+            });
+        // keep well clear of overflowing
+        uint32_t max = 0;
+        for (int y=0; y < height_; y++) { if (row_max_[y] > max) max = row_max_[y]; }
+        if (max >= (1U << 31)) {
+            for (size_t i=0; i < hits_.size(); i++) { hits_[i] >>= 1; }
+            for (int y=0; y < height_; y++) { row_max_[y] >>= 1; }
+        }
+    }
+
+    // Log density of each pixel as 1-255, 255 for the most often hit,
+    // and 0 for never.
+    void ToneMap(uint8_t out[]) const {
+        uint32_t max = 0;
+        for (int y=0; y < height_; y++) { if (row_max_[y] > max) max = row_max_[y]; }
+        const float k = (max > 0) ? 254.0f / logf(1.0f + max) : 0;
+        for (size_t i=0; i < hits_.size(); i++) {
+            out[i] = hits_[i] ? 1 + (uint8_t)(logf(1.0f + hits_[i]) * k) : 0;
+        }
+    }
+
+private:
+    struct Thread {
+        std::vector<uint32_t> hits;
+        uint64_t rng;
+        float x, y;
+    };
+
+    void Run(int count, const std::function<void(int)> &fn) {
+        if (pool_) {
+            pool_->Run(count, fn);
+        } else {
+            for (int i=0; i < count; i++) { fn(i); }
+        }
+    }
+
+    // one step of the chaos game
+    void Jump(Thread &t) const {
+        // xorshift64*
+        t.rng ^= t.rng >> 12;
+        t.rng ^= t.rng << 25;
+        t.rng ^= t.rng >> 27;
+        const uint32_t r = (t.rng * 0x2545F4914F6CDD1DULL) >> 32;
+        size_t i = 0;
+        while (i + 1 < maps_.size() && r >= threshold_[i]) { i++; }
+        const IfsMap &m = maps_[i];
+        const float x = m.a * t.x + m.b * t.y + m.e;
+        t.y = m.c * t.x + m.d * t.y + m.f;
+        t.x = x;
+    }
+
+    // scale the fractal to fill the display, keeping its shape, y up
+    void Fit() {
+        Thread t;
+        t.rng = 0x2545F4914F6CDD1DULL;
+        t.x = t.y = 0;
+        float x0 = 1e30f, x1 = -1e30f, y0 = 1e30f, y1 = -1e30f;
+        for (int k=0; k < 20000; k++) {
+            Jump(t);
+            if (k < 32) continue;
+            if (t.x < x0) x0 = t.x;
+            if (t.x > x1) x1 = t.x;
+            if (t.y < y0) y0 = t.y;
+            if (t.y > y1) y1 = t.y;
+        }
+        const float w = (x1 > x0) ? x1 - x0 : 1, h = (y1 > y0) ? y1 - y0 : 1;
+        const float scale = fminf(width_ / w, height_ / h) * 0.999f;
+        scale_x_ = scale;
+        scale_y_ = -scale;
+        offset_x_ = (width_ - w * scale) / 2 - x0 * scale;
+        offset_y_ = height_ - (height_ - h * scale) / 2 + y0 * scale;
+    }
+
+    const int width_, height_;
+    std::vector<IfsMap> maps_;
+    uint32_t threshold_[IFS_MAX_MAPS];
+    float scale_x_, scale_y_, offset_x_, offset_y_;   // to pixels
+    ThreadPool *pool_;
+    std::vector<uint32_t> hits_;
+    std::vector<uint32_t> row_max_;
+    std::vector<Thread> threads_;
+};
+
+#endif  // IFS_H
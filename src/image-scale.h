@@ -0,0 +1,156 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// image-scale.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Scaling of 8-bit images (palette indexes, or one color channel at a time)
+// in 16.16 fixed point, for zooms, sprites and supersampling.
+//
+// ImageScaler does bilinear filtering. The source position and weights of
+// every destination row and column are worked out once in SetRows() and
+// SetColumns(), then Scale() filters each row in two passes: first the two
+// source rows are blended over their whole (contiguous) width with SIMD,
+// then each destination pixel blends two neighbours of that blended row.
+// The result is the same as the usual four-tap formula
+//
+//   ( a*(256-wy)*(256-wx) + b*(256-wy)*wx + c*wy*(256-wx) + d*wy*wx ) >> 16
+//
+// bit for bit, only with fewer multiplies and no weights in the inner loop.
+//
+// accumulateRow() and boxReduceRow() are for the opposite direction:
+// averaging 'scale' x 'scale' blocks of a supersampled image.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef IMAGE_SCALE_H
+#define IMAGE_SCALE_H
+
+#include <stdint.h>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+class ImageScaler {
+public:
+    ImageScaler() {}
+
+    // Destination column i samples the source at 16.16 position
+    // start + i * delta. delta must not be negative. The pixel to the right
+    // of every position is read too, so it has to be inside the source.
+    void SetColumns(int count, int start, int delta) {
+        SetTaps(count, start, delta, &col_, &col_w_);
+        // positions are kept relative to the first source column needed
+        col_min_ = col_.empty() ? 0 : col_[0];
+        for (int i=0; i < count; i++) { col_[i] -= col_min_; }
+        vert_.resize(count ? col_[count - 1] + 2 : 0);
+    }
+
+    // Same for destination rows. The row below every position is read too.
+    void SetRows(int count, int start, int delta) {
+        SetTaps(count, start, delta, &row_, &row_w_);
+    }
+
+    // Filter 'src' into 'dst' as set up above. Strides are in bytes.
+    void Scale(const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride) {
+        const int width = (int)col_.size();
+        const int span = (int)vert_.size();
+        for (size_t j=0; j < row_.size(); j++) {
+            const uint8_t *a = src + (long)row_[j] * src_stride + col_min_;
+            BlendRows(a, a + src_stride, row_w_[j], &vert_[0], span);
+
+            uint8_t *out = dst + (long)j * dst_stride;
+            for (int i=0; i < width; i++) {
+                const uint32_t w = col_w_[i];
+                const uint16_t *v = &vert_[col_[i]];
+                out[i] = (v[0] * (256 - w) + v[1] * w) >> 16;
+            }
+        }
+    }
+
+private:
+    static void SetTaps(int count, int start, int delta,
+                        std::vector<int> *pos, std::vector<uint16_t> *weight) {
+        pos->resize(count);
+        weight->resize(count);
+        int p = start;
+        for (int i=0; i < count; i++) {
+            (*pos)[i] = p >> 16;
+            (*weight)[i] = (p >> 8) & 0xff;
+            p += delta;
+        }
+    }
+
+    // out[x] = a[x]*(256-w) + b[x]*w, which always fits 16 bits
+    static void BlendRows(const uint8_t *a, const uint8_t *b, int w, uint16_t *out, int n) {
+        int x = 0;
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i wa = _mm_set1_epi16(256 - w);
+        const __m128i wb = _mm_set1_epi16(w);
+        for (; x + 16 <= n; x += 16) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + x));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + x));
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), wa),
+                                       _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb));
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), wa),
+                                       _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb));
+            _mm_storeu_si128((__m128i *)(out + x), lo);
+            _mm_storeu_si128((__m128i *)(out + x + 8), hi);
+        }
+#endif
+        for (; x < n; x++) {
+            out[x] = a[x] * (256 - w) + b[x] * w;
+        }
+    }
+
+    std::vector<int> col_, row_;
+    std::vector<uint16_t> col_w_, row_w_;   // weight of the right/lower sample
+    std::vector<uint16_t> vert_;            // the current row, blended vertically
+    int col_min_;
+};
+
+// acc[x] += row[x], widening 8 to 16 bits
+static inline void accumulateRow(const uint8_t *row, uint16_t *acc, int n) {
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 16 <= n; x += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(row + x));
+        __m128i lo = _mm_loadu_si128((const __m128i *)(acc + x));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(acc + x + 8));
+        _mm_storeu_si128((__m128i *)(acc + x),     _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128((__m128i *)(acc + x + 8), _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero)));
+    }
+#endif
+    for (; x < n; x++) {
+        acc[x] += row[x];
+    }
+}
+
+// Average 'scale' rows that were summed up with accumulateRow() in groups
+// of 'scale' columns, giving n output pixels.
+static inline void boxReduceRow(const uint16_t *acc, int scale, uint8_t *out, int n) {
+    const int area = scale * scale;
+    for (int x=0; x < n; x++) {
+        int sum = 0;
+        for (int k=0; k < scale; k++) { sum += acc[x * scale + k]; }
+        out[x] = sum / area;
+    }
+}
+
+#endif  // IMAGE_SCALE_H
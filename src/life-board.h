@@ -0,0 +1,351 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// life-board.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Conway's Game of Life on a wrap-around board, 64 cells to a word.
+// Each generation works on whole words: the 8 neighbours of 64 cells are
+// the row above, the row itself and the row below, each shifted one cell
+// left and right, and they're added up bit-parallel with full adders
+// instead of being counted one cell at a time. Two boards are kept, so
+// a step just writes the other one and swaps.
+//
+// The board is split into tiles one word wide and TILE_ROWS high, and only
+// tiles next to one that differs from two generations ago are computed.
+// For all others the next generation is the same as the previous one,
+// which the other board still holds, so they can be skipped. This covers
+// still lifes as well as blinkers and other period-2 oscillators, so once
+// most of a board has settled, only the tiles with something going on
+// cost anything.
+//
+// A 64-bit hash of the board is kept up to date as it changes, for
+// spotting a board that has died or settled into a cycle. It is the XOR of
+// a hash of every word with its position, so a step only has to rehash
+// the words that changed. A skipped tile changes the hash by the same
+// amount as in its last step, as it just flips back.
+//
+// Big boards can be stepped by a thread pool, in horizontal bands of tile
+// rows. Each band reads the rows around it (its halo) from the current
+// board and only writes its own rows of the next one, so the bands need
+// no locking, only a barrier between generations, which is the pool
+// finishing its job.
+//
+// Cell x of a row is bit (x % 64) of word (x / 64). Bits past the width in
+// the last word of a row are always zero.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef LIFE_BOARD_H
+#define LIFE_BOARD_H
+
+#include "life-engine.h"
+#include "thread-pool.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define TILE_ROWS 16   // rows per tile, tiles are one word (64 cells) wide
+#define BAND_WORDS 4096   // boards smaller than this many words aren't split
+#define BANDS_PER_THREAD 4   // more bands than threads even out the work
+
+class LifeBoard : public LifeEngine {
+public:
+    LifeBoard(int width, int height)
+        : width_(width), height_(height), words_((width + 63) / 64), steps_(1),
+          tiles_y_((height + TILE_ROWS - 1) / TILE_ROWS),
+          cur_(words_ * height, 0), next_(words_ * height, 0),
+          changed_(words_ * tiles_y_, 1), touched_(words_ * tiles_y_, 1),
+          flips_(words_ * tiles_y_, 1), active_(words_ * tiles_y_, 0),
+          dirty_(words_ * tiles_y_, 1), delta_(words_ * tiles_y_, 0),
+          hash_(0), pool_(NULL) {
+        last_mask_ = (width % 64) ? (1ULL << (width % 64)) - 1 : ~0ULL;
+        top_ = (width - 1) & 63;
+        SetPool(NULL);
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // generations per Run()
+    void SetSteps(int steps) { steps_ = steps; }
+
+    // Step in bands on 'pool', if the board is big enough to be worth it.
+    // NULL steps on the calling thread.
+    void SetPool(ThreadPool *pool) {
+        int bands = 1;
+        if (pool && (long)words_ * height_ >= BAND_WORDS) {
+            bands = (pool->size() + 1) * BANDS_PER_THREAD;
+            if (bands > tiles_y_) bands = tiles_y_;
+        }
+        pool_ = (bands > 1) ? pool : NULL;
+        scratch_.resize(bands);
+        for (int b=0; b < bands; b++) { scratch_[b].Resize(words_); }
+    }
+
+    virtual bool Get(int x, int y) const {
+        return (cur_[y * words_ + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    virtual void Set(int x, int y, bool alive) {
+        const int i = y * words_ + (x >> 6);
+        uint64_t &w = cur_[i];
+        const uint64_t bit = 1ULL << (x & 63);
+        hash_ ^= HashWord(w, i);
+        w = alive ? (w | bit) : (w & ~bit);
+        hash_ ^= HashWord(w, i);
+        const int t = Tile(x >> 6, y / TILE_ROWS);
+        changed_[t] = touched_[t] = dirty_[t] = 1;
+    }
+
+    virtual void Clear() {
+        memset(&cur_[0], 0, cur_.size() * sizeof(uint64_t));
+        changed_.assign(changed_.size(), 1);
+        touched_.assign(touched_.size(), 1);
+        dirty_.assign(dirty_.size(), 1);
+        hash_ = 0;
+    }
+
+    virtual void Run() {
+        for (int i=0; i < steps_; i++) { Step(); }
+    }
+
+    // tiles that changed since the last ClearChanged()
+    virtual bool Changed(int x, int y) const { return dirty_[Tile(x >> 6, y / TILE_ROWS)]; }
+    virtual void ClearChanged() { dirty_.assign(dirty_.size(), 0); }
+
+    // 0 for an empty board
+    virtual uint64_t Hash() const { return hash_; }
+
+    // one generation
+    void Step() {
+        const int bands = (int)scratch_.size();
+        if (pool_) {
+            // all bands must know what's active before any changes it
+            pool_->Run(bands, [this](int b) { MarkBand(b); });
+            pool_->Run(bands, [this](int b) { StepBand(b); });
+        } else {
+            MarkBand(0);
+            StepBand(0);
+        }
+        for (int b=0; b < bands; b++) { hash_ ^= scratch_[b].hash; }
+        cur_.swap(next_);
+    }
+
+    // number of tiles computed by the last Step()
+    int active() const {
+        int n = 0;
+        for (size_t t=0; t < active_.size(); t++) { n += active_[t]; }
+        return n;
+    }
+
+private:
+    int Tile(int tx, int ty) const { return ty * words_ + tx; }
+
+    // tile rows [first, last) of band b
+    void BandRows(int b, int *first, int *last) const {
+        const int bands = (int)scratch_.size();
+        *first = (int)((long)tiles_y_ * b / bands);
+        *last = (int)((long)tiles_y_ * (b + 1) / bands);
+    }
+
+    // a tile needs computing if it or a neighbour changed
+    void MarkBand(int b) {
+        int first, last;
+        BandRows(b, &first, &last);
+        for (int ty=first; ty < last; ty++) {
+            for (int tx=0; tx < words_; tx++) {
+                uint8_t a = 0;
+                for (int dy=-1; dy <= 1; dy++) {
+                    const int y = (ty + dy + tiles_y_) % tiles_y_;
+                    for (int dx=-1; dx <= 1; dx++) {
+                        a |= changed_[Tile((tx + dx + words_) % words_, y)];
+                    }
+                }
+                active_[Tile(tx, ty)] = a;
+            }
+        }
+    }
+
+    void StepBand(int b) {
+        int first, last;
+        BandRows(b, &first, &last);
+        scratch_[b].hash = 0;
+        for (int ty=first; ty < last; ty++) {
+            StepTileRow(ty, &scratch_[b]);
+        }
+    }
+
+    // per-row sums of three rows, the changes of each word of a tile row
+    struct Scratch {
+        std::vector<uint64_t> s[3], c[3], hs[3], hc[3];
+        std::vector<uint64_t> diff, diff2;
+        uint64_t hash;   // change of the board hash by this band
+        void Resize(int words) {
+            for (int k=0; k < 3; k++) {
+                s[k].resize(words); c[k].resize(words);
+                hs[k].resize(words); hc[k].resize(words);
+            }
+            diff.resize(words);
+            diff2.resize(words);
+        }
+    };
+
+    // compute the active tiles of one row of tiles
+    void StepTileRow(int ty, Scratch *scratch) {
+        for (int a=0; a < words_; ) {
+            if (!active_[Tile(a, ty)]) {
+                changed_[Tile(a, ty)] = 0;
+                a++;
+                continue;
+            }
+            // a run of neighbouring active tiles is computed in one go
+            int b = a + 1;
+            while (b < words_ && active_[Tile(b, ty)]) { b++; }
+            StepSpan(a, b, ty, scratch);
+            for (int i=a; i < b; i++) {
+                const int t = Tile(i, ty);
+                changed_[t] = (scratch->diff2[i] != 0);
+                flips_[t] = (scratch->diff[i] != 0);
+                // cells set by hand have no real previous generation to
+                // compare with, so they count as changed once more
+                changed_[t] |= touched_[t];
+                touched_[t] = 0;
+                delta_[t] = flips_[t] ? TileDelta(i, ty) : 0;
+            }
+            a = b;
+        }
+        // skipped tiles flip like they did before
+        for (int i=0; i < words_; i++) {
+            const int t = Tile(i, ty);
+            dirty_[t] |= flips_[t];
+            scratch->hash ^= delta_[t];
+        }
+    }
+
+    // change of the board hash by the words of a tile that were just computed
+    uint64_t TileDelta(int tx, int ty) const {
+        const int y0 = ty * TILE_ROWS;
+        const int y1 = (y0 + TILE_ROWS < height_) ? y0 + TILE_ROWS : height_;
+        uint64_t h = 0;
+        for (int y=y0; y < y1; y++) {
+            const int i = y * words_ + tx;
+            if (cur_[i] != next_[i]) { h ^= HashWord(cur_[i], i) ^ HashWord(next_[i], i); }
+        }
+        return h;
+    }
+
+    // Horizontal neighbour counts of words [a, b) of row y into slot k, as
+    // two bits per cell: ones and twos. s/c count the cell itself too (for
+    // the rows above and below), hs/hc don't (for the row itself).
+    void RowSums(int y, int a, int b, int k, Scratch *scratch) const {
+        const uint64_t *row = &cur_[y * words_];
+        uint64_t *s = &scratch->s[k][0], *c = &scratch->c[k][0];
+        uint64_t *hs = &scratch->hs[k][0], *hc = &scratch->hc[k][0];
+        // the first and last word of a row wrap around, the rest is a
+        // plain loop that vectorizes
+        const int lo = (a > 0) ? a : 1;
+        const int hi = (b < words_) ? b : words_ - 1;
+        for (int i=lo; i < hi; i++) {
+            // neighbours to the west (x-1) and east (x+1)
+            const uint64_t w = (row[i] << 1) | (row[i - 1] >> 63);
+            const uint64_t e = (row[i] >> 1) | (row[i + 1] << 63);
+            hs[i] = w ^ e;
+            hc[i] = w & e;
+            s[i] = hs[i] ^ row[i];
+            c[i] = hc[i] | (hs[i] & row[i]);
+        }
+        if (a == 0) EdgeSums(row, 0, s, c, hs, hc);
+        if (b == words_ && words_ > 1) EdgeSums(row, words_ - 1, s, c, hs, hc);
+    }
+
+    void EdgeSums(const uint64_t *row, int i, uint64_t *s, uint64_t *c,
+                  uint64_t *hs, uint64_t *hc) const {
+        const int last = words_ - 1;
+        const uint64_t west_bit = (i > 0) ? row[i - 1] >> 63 : (row[last] >> top_) & 1;
+        const uint64_t east_bit = (i < last) ? row[i + 1] & 1 : row[0] & 1;
+        uint64_t w = (row[i] << 1) | west_bit;
+        uint64_t e = (row[i] >> 1);
+        if (i == last) {
+            w &= last_mask_;
+            e |= east_bit << top_;
+        } else {
+            e |= east_bit << 63;
+        }
+        hs[i] = w ^ e;
+        hc[i] = w & e;
+        s[i] = hs[i] ^ row[i];
+        c[i] = hc[i] | (hs[i] & row[i]);
+    }
+
+    // Compute words [a, b) of tile row ty into next_. Leaves which words
+    // differ from now in diff, and from two generations ago in diff2.
+    void StepSpan(int a, int b, int ty, Scratch *scratch) {
+        const int y0 = ty * TILE_ROWS;
+        const int y1 = (y0 + TILE_ROWS < height_) ? y0 + TILE_ROWS : height_;
+        uint64_t *diff = &scratch->diff[0], *diff2 = &scratch->diff2[0];
+        for (int i=a; i < b; i++) { diff[i] = diff2[i] = 0; }
+
+        // horizontal sums of three rows at a time, each row is summed once
+        int above = 0, mid = 1, below = 2;
+        RowSums((y0 - 1 + height_) % height_, a, b, above, scratch);
+        RowSums(y0, a, b, mid, scratch);
+        for (int y=y0; y < y1; y++) {
+            RowSums((y + 1 < height_) ? y + 1 : 0, a, b, below, scratch);
+            const uint64_t *sa = &scratch->s[above][0], *sb = &scratch->hs[mid][0], *sc = &scratch->s[below][0];
+            const uint64_t *ca = &scratch->c[above][0], *cb = &scratch->hc[mid][0], *cc = &scratch->c[below][0];
+            const uint64_t *row = &cur_[y * words_];
+            uint64_t *out = &next_[y * words_];
+            for (int i=a; i < b; i++) {
+                // ones: full adder of the three sums, its carry is worth two
+                const uint64_t ones = sa[i] ^ sb[i] ^ sc[i];
+                const uint64_t k = (sa[i] & sb[i]) | (sa[i] & sc[i]) | (sb[i] & sc[i]);
+                // twos: exactly one of the four carries set means 2 or 3 neighbours
+                const uint64_t p1 = ca[i] ^ cb[i], q1 = ca[i] & cb[i];
+                const uint64_t p2 = cc[i] ^ k, q2 = cc[i] & k;
+                const uint64_t two = (p1 ^ p2) & ~(q1 | q2 | (p1 & p2));
+                // 3 neighbours, or 2 and alive
+                const uint64_t next = two & (ones | row[i]);
+                diff[i] |= next ^ row[i];
+                diff2[i] |= next ^ out[i];
+                out[i] = next;
+            }
+            const int tmp = above;
+            above = mid;
+            mid = below;
+            below = tmp;
+        }
+    }
+
+    int width_, height_;
+    int words_;                     // words per row, and tiles per row
+    int steps_;
+    int tiles_y_;                   // tiles per column
+    uint64_t last_mask_;            // valid bits of the last word of a row
+    int top_;                       // highest valid bit of the last word
+    std::vector<uint64_t> cur_, next_;
+    std::vector<uint8_t> changed_;  // tiles that differ from two generations ago
+    std::vector<uint8_t> touched_;  // tiles Set() since the last step
+    std::vector<uint8_t> flips_;    // tiles that changed in their last step
+    std::vector<uint8_t> active_;   // tiles computed in this step
+    std::vector<uint8_t> dirty_;    // tiles changed since ClearChanged()
+    std::vector<uint64_t> delta_;   // change of the hash by a tile's last step
+    uint64_t hash_;
+    std::vector<Scratch> scratch_;  // one per band
+    ThreadPool *pool_;
+};
+
+#endif  // LIFE_BOARD_H
@@ -0,0 +1,68 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// life-engine.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// What the Life demo needs from an engine running the Game of Life, so
+// that a small wrap-around board and a huge HashLife universe can be
+// swapped for each other. Cells are set and read in display coordinates;
+// how a display pixel maps to cells is up to the engine.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef LIFE_ENGINE_H
+#define LIFE_ENGINE_H
+
+#include <stdint.h>
+
+class LifeEngine {
+public:
+    virtual ~LifeEngine() {}
+
+    // kill all cells
+    virtual void Clear() = 0;
+
+    // cell at display pixel x,y
+    virtual void Set(int x, int y, bool alive) = 0;
+    virtual bool Get(int x, int y) const = 0;
+
+    // 0 dead, 1 alive, 2 and up fading out in rules with more states
+    virtual int State(int x, int y) const { return Get(x, y); }
+    virtual int States() const { return 2; }
+
+    // advance the generations of one frame
+    virtual void Run() = 0;
+
+    // False if the cell at x,y is known to be the same as it was at the
+    // last ClearChanged(), so the display doesn't need to redraw it.
+    virtual bool Changed(int x, int y) const { return true; }
+    virtual void ClearChanged() {}
+
+    // Hash of what's on the display, the same whenever it looks the same
+    // and 0 when it is empty. For spotting a board that stopped changing.
+    virtual uint64_t Hash() const = 0;
+
+    // Hash of word i of a board, for engines that hash boards a word at a
+    // time by XOR-ing these. Empty words don't count.
+    static uint64_t HashWord(uint64_t w, uint64_t i) {
+        if (w == 0) return 0;
+        // one round of a multiply-xorshift mixer is plenty for this
+        const uint64_t h = (w ^ (i * 0x9e3779b97f4a7c15ULL)) * 0xbf58476d1ce4e5b9ULL;
+        return h ^ (h >> 29);
+    }
+};
+
+#endif  // LIFE_ENGINE_H
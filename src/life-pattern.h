@@ -0,0 +1,212 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// life-pattern.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Reads Game of Life patterns in the common file formats:
+//
+//   .rle        run length encoded, "x = 3, y = 3" header, then e.g. bo$2bo$3o!
+//   .cells      plain text, '.' dead and 'O' alive, '!' comment lines
+//   Life 1.06   "#Life 1.06", then the x y coordinates of each live cell
+//
+// The format is told from the contents, not the file name. Files are read
+// a character at a time and every live cell is handed straight to a
+// callback, so nothing is held in memory however big the pattern is.
+//
+// Usage:
+//
+//  LifePatternReader pattern;
+//  int x, y, w, h;
+//  if (pattern.Open(filename) && pattern.Bounds(&x, &y, &w, &h)) {
+//      pattern.Read([&](int cx, int cy) { board.Set(cx - x, cy - y, true); });
+//  }
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef LIFE_PATTERN_H
+#define LIFE_PATTERN_H
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class LifePatternReader {
+public:
+    enum Format { RLE, CELLS, LIFE106 };
+
+    LifePatternReader() : f_(NULL), format_(CELLS), start_(0), width_(-1), height_(-1) {
+        rule_[0] = 0;
+    }
+    ~LifePatternReader() { if (f_) fclose(f_); }
+
+    // Open a pattern file and read its header. False if it can't be read.
+    bool Open(const char *filename) {
+        if (f_) fclose(f_);
+        if ((f_ = fopen(filename, "r")) == NULL) return false;
+
+        char line[256];
+        long pos = ftell(f_);
+        if (!fgets(line, sizeof(line), f_)) return false;
+        if (strncmp(line, "#Life 1.06", 10) == 0) {
+            format_ = LIFE106;
+            start_ = ftell(f_);
+            return true;
+        }
+        // skip comments, then an RLE file has its header line
+        while (line[0] == '#' || line[0] == '!') {
+            if (!EndOfLine(line)) SkipLine();
+            pos = ftell(f_);
+            if (!fgets(line, sizeof(line), f_)) {
+                line[0] = 0;
+                break;
+            }
+        }
+        if (line[0] == 'x') {
+            format_ = RLE;
+            if (sscanf(line, "x = %d , y = %d", &width_, &height_) != 2) return false;
+            const char *rule = strstr(line, "rule");
+            if (rule && sscanf(rule, "rule = %31[^ \r\n]", rule_) != 1) rule_[0] = 0;
+            if (!EndOfLine(line)) SkipLine();
+            start_ = ftell(f_);
+        } else {
+            format_ = CELLS;
+            start_ = pos;
+        }
+        return true;
+    }
+
+    Format format() const { return format_; }
+
+    // rule from an RLE header, e.g. "B3/S23", or "" if none was given
+    const char *rule() const { return rule_; }
+
+    // Smallest rectangle holding all live cells. RLE files give their size
+    // up front, the other formats are read through once to find it.
+    bool Bounds(int *x, int *y, int *width, int *height) {
+        if (format_ == RLE) {
+            *x = *y = 0;
+            *width = width_;
+            *height = height_;
+            return true;
+        }
+        int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+        if (!Read([&](int cx, int cy) {
+                    if (cx < x0) x0 = cx;
+                    if (cx > x1) x1 = cx;
+                    if (cy < y0) y0 = cy;
+                    if (cy > y1) y1 = cy;
+                })) return false;
+        if (x0 > x1) x0 = x1 = y0 = y1 = 0;   // no live cells
+        *x = x0;
+        *y = y0;
+        *width = x1 - x0 + 1;
+        *height = y1 - y0 + 1;
+        return true;
+    }
+
+    // Call cell(x, y) for every live cell. False on a syntax error, after
+    // the cells up to it were passed on.
+    template <class Sink> bool Read(Sink cell) {
+        if (!f_ || fseek(f_, start_, SEEK_SET) != 0) return false;
+        switch (format_) {
+        case RLE:     return ReadRLE(cell);
+        case CELLS:   return ReadCells(cell);
+        case LIFE106: return ReadLife106(cell);
+        }
+        return false;
+    }
+
+private:
+    static bool EndOfLine(const char *line) { return strchr(line, '\n') != NULL; }
+
+    void SkipLine() {
+        int c;
+        while ((c = getc_unlocked(f_)) != EOF && c != '\n') {}
+    }
+
+    template <class Sink> bool ReadRLE(Sink &cell) {
+        int x = 0, y = 0, n = 0, c;
+        while ((c = getc_unlocked(f_)) != EOF && c != '!') {
+            if (c >= '0' && c <= '9') {
+                n = n * 10 + (c - '0');
+                continue;
+            }
+            const int run = n ? n : 1;
+            n = 0;
+            if (c == 'b' || c == '.') {
+                x += run;
+            } else if (c == '$') {
+                x = 0;
+                y += run;
+            } else if (c == 'o' || (c >= 'A' && c <= 'X') || (c >= 'p' && c <= 'y')) {
+                // any state of a multi-state rule counts as alive. p-y start
+                // a two letter state.
+                if (c >= 'p' && c <= 'y' && getc_unlocked(f_) == EOF) return false;
+                for (int i=0; i < run; i++) { cell(x++, y); }
+            } else if (c == '#') {
+                SkipLine();
+            } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Sink> bool ReadCells(Sink &cell) {
+        int x = 0, y = 0, c;
+        while ((c = getc_unlocked(f_)) != EOF) {
+            if (c == '\n') {
+                x = 0;
+                y++;
+            } else if (c == 'O' || c == 'o' || c == '*') {
+                cell(x++, y);
+            } else if (c == '.' || c == ' ') {
+                x++;
+            } else if (c == '!' && x == 0) {
+                SkipLine();
+            } else if (c != '\r' && c != '\t') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Sink> bool ReadLife106(Sink &cell) {
+        int c;
+        while ((c = getc_unlocked(f_)) != EOF) {
+            if (c == '#') {
+                SkipLine();
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                ungetc(c, f_);
+                int x, y;
+                if (fscanf(f_, "%d %d", &x, &y) != 2) return false;
+                cell(x, y);
+            } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FILE *f_;
+    Format format_;
+    long start_;        // where the cells begin
+    int width_, height_;  // from the RLE header
+    char rule_[32];
+};
+
+#endif  // LIFE_PATTERN_H
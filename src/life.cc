@@ -40,6 +40,10 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "life-board.h"
+#include "hashlife.h"
+#include "life-pattern.h"
+#include "ca-board.h"
 
 #include <getopt.h>
 #include <stdio.h>
@@ -51,11 +55,14 @@
 #include <string>
 #include <string.h>
 #include <signal.h>
+#include <vector>
 
 // Defaults
 #define Z_LAYER 2      // (0-15) 0=background
 #define DELAY 200
 #define NUM_DOTS 6
+#define PERIOD 30      // frames a repeat is looked back for
+#define MAX_PERIOD 1000
 
 volatile bool interrupt_received = false;
 static void InterruptHandler(int signo) {
@@ -78,6 +85,17 @@ bool opt_fgcolor = false, opt_bgcolor = false;
 int opt_fg_R=0, opt_fg_G=0, opt_fg_B=0;
 int opt_bg_R=0, opt_bg_G=0, opt_bg_B=0;
 int opt_num_dots = NUM_DOTS;
+int opt_steps = 1;
+int opt_hashlife = -1;  // HashLife generations per frame (log2), -1 = off
+int opt_zoom = 0;
+int opt_threads = -1;  // worker threads, default one per core
+int opt_period = PERIOD;
+std::vector<const char *> opt_patterns;
+bool opt_place = false;  // -o given
+int opt_place_x = 0, opt_place_y = 0;
+int opt_tile = -1;  // gap between tiled copies, -1 = one copy
+bool opt_wrap = false;
+CaRule opt_rule;  // B3/S23
 
 int usage(const char *progname) {
 
@@ -88,11 +106,23 @@ int usage(const char *progname) {
         "\t-l <layer>     : Layer 0-15. (default 2)\n"
         "\t-t <timeout>   : Timeout exits after given seconds. (default 24hrs)\n"
         "\t-r <seconds>   : Respawn random dots after given seconds.\n"
+        "\t-p <frames>    : Respawn once the board dies or repeats within this many\n"
+        "\t                 frames, up to 1000. (0 = never, default 30)\n"
         "\t-h <host>      : Flaschen-Taschen display hostname. (FT_DISPLAY)\n"
         "\t-d <delay>     : Delay between frames in milliseconds. (default 200)\n"
         "\t-c <RRGGBB>    : Forground color in hex (-c0 = transparent, default cycles)\n"
         "\t-b <RRGGBB>    : Background color in hex (-b0 = #010101, default transparent)\n"
         "\t-n <number>    : Initialize with 1/n random dots. (default 6)\n"
+        "\t-f <file>      : Start with a pattern from an .rle, .cells or Life 1.06 file.\n"
+        "\t                 Give several to play them in turn on every respawn.\n"
+        "\t-o <X>,<Y>     : Put the pattern's top left corner here. (default centered)\n"
+        "\t-T <gap>       : Tile the display with copies of the pattern, <gap> apart.\n"
+        "\t-w             : Wrap pattern cells past the edges around. (default clips)\n"
+        "\t-s <steps>     : Generations per frame, to fast-forward. (default 1)\n"
+        "\t-R <rule>      : Rule, e.g. B36/S23, Generations /2/3 or 1D W30. (default B3/S23)\n"
+        "\t-H <n>         : Use HashLife on an unbounded universe, 2^n generations per frame.\n"
+        "\t-z <zoom>      : With -H, each pixel shows 2^zoom x 2^zoom cells. (default 0)\n"
+        "\t-j <threads>   : Threads stepping big boards. (default 1 per core)\n"
     );
     return 1;
 }
@@ -101,7 +131,7 @@ int cmdLine(int argc, char *argv[]) {
 
     // command line options
     int opt;
-    while ((opt = getopt(argc, argv, "?g:l:t:r:h:d:c:b:n:")) != -1) {
+    while ((opt = getopt(argc, argv, "?g:l:t:r:p:h:d:c:b:n:f:o:T:wR:s:H:z:j:")) != -1) {
         switch (opt) {
         case '?':  // help
             return usage(argv[0]);
@@ -130,6 +160,12 @@ int cmdLine(int argc, char *argv[]) {
                 return usage(argv[0]);
             }
             break;
+        case 'p':  // stagnation period
+            if (sscanf(optarg, "%d", &opt_period) != 1 || opt_period < 0 || opt_period > MAX_PERIOD) {
+                fprintf(stderr, "Invalid period '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
         case 'h':  // hostname
             opt_hostname = strdup(optarg); // leaking. Ignore.
             break;
@@ -159,15 +195,87 @@ int cmdLine(int argc, char *argv[]) {
                 return usage(argv[0]);
             }
             break;
+        case 'f': {  // pattern file
+            LifePatternReader pattern;
+            if (!pattern.Open(optarg)) {
+                fprintf(stderr, "Invalid pattern file '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_patterns.push_back(strdup(optarg)); // leaking. Ignore.
+            break;
+        }
+        case 'o':  // pattern placement
+            if (sscanf(optarg, "%d,%d", &opt_place_x, &opt_place_y) != 2) {
+                fprintf(stderr, "Invalid position '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_place = true;
+            break;
+        case 'T':  // tile pattern
+            if (sscanf(optarg, "%d", &opt_tile) != 1 || opt_tile < 0) {
+                fprintf(stderr, "Invalid tile gap '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'w':  // wrap pattern
+            opt_wrap = true;
+            break;
+        case 'R':  // rule
+            if (!opt_rule.Parse(optarg)) {
+                fprintf(stderr, "Invalid rule '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 's':  // generations per frame
+            if (sscanf(optarg, "%d", &opt_steps) != 1 || opt_steps < 1) {
+                fprintf(stderr, "Invalid steps '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'H':  // HashLife
+            if (sscanf(optarg, "%d", &opt_hashlife) != 1 || opt_hashlife < 0 || opt_hashlife > 40) {
+                fprintf(stderr, "Invalid HashLife step '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'z':  // zoom
+            if (sscanf(optarg, "%d", &opt_zoom) != 1 || opt_zoom < 0 || opt_zoom > 30) {
+                fprintf(stderr, "Invalid zoom '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'j':  // threads
+            if (sscanf(optarg, "%d", &opt_threads) != 1 || opt_threads < 1) {
+                fprintf(stderr, "Invalid number of threads '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            // the main thread steps too
+            opt_threads--;
+            break;
         default:
             return usage(argv[0]);
         }
     }
+    if (opt_hashlife >= 0 && !opt_rule.conway()) {
+        fprintf(stderr, "HashLife only runs B3/S23\n");
+        return usage(argv[0]);
+    }
     return 0;
 }
 
 // ------------------------------------------------------------------------------------------
 
+// board hashes of the last frames, a ring
+uint64_t glob_hashes[MAX_PERIOD];
+int glob_num_hashes = 0, glob_hash_pos = 0;
+
+// next pattern of the playlist
+size_t glob_pattern = 0;
+
+// 1D rules: each row colored once, in a ring like the engine's rows
+std::vector<Color> glob_rain;
+int glob_rain_new = 0;  // rows at the top not colored yet
+
 // random int in range min to max inclusive
 int randomInt(int min, int max) {
   return (random() % (max - min + 1) + min);
@@ -183,35 +291,126 @@ void colorGradient(int start, int end, int r1, int g1, int b1, int r2, int g2, i
     }
 }
 
-void initGameOfLife(int width, int height, uint8_t pixels[]) {
+// Place the pattern from a file on the display, as set by the options.
+// The board must be clear.
+bool loadPattern(LifeEngine &life, const char *filename) {
+
+    LifePatternReader pattern;
+    int px, py, pw, ph;
+    if (!pattern.Open(filename) || !pattern.Bounds(&px, &py, &pw, &ph)) return false;
+
+    // top left corner of the pattern
+    int x0 = opt_place ? opt_place_x : (opt_width - pw) / 2;
+    int y0 = opt_place ? opt_place_y : (opt_height - ph) / 2;
+
+    // copies repeat this far apart, starting left of and above the display
+    int step_x = 0, step_y = 0, nx = 1, ny = 1;
+    if (opt_tile >= 0) {
+        step_x = ((pw > 0) ? pw : 1) + opt_tile;
+        step_y = ((ph > 0) ? ph : 1) + opt_tile;
+        // the first copy that reaches into the display
+        while (x0 + pw <= 0) { x0 += step_x; }
+        while (x0 + pw > step_x) { x0 -= step_x; }
+        while (y0 + ph <= 0) { y0 += step_y; }
+        while (y0 + ph > step_y) { y0 -= step_y; }
+        nx = (opt_width - x0 + step_x - 1) / step_x;
+        ny = (opt_height - y0 + step_y - 1) / step_y;
+    }
+    x0 -= px;
+    y0 -= py;
+
+    const bool unbounded = (opt_hashlife >= 0);
+    return pattern.Read([&](int cx, int cy) {
+        for (int j=0; j < ny; j++) {
+            for (int i=0; i < nx; i++) {
+                int x = x0 + cx + i * step_x, y = y0 + cy + j * step_y;
+                if (!unbounded) {
+                    if (opt_wrap) {
+                        x = ((x % opt_width) + opt_width) % opt_width;
+                        y = ((y % opt_height) + opt_height) % opt_height;
+                    } else if (x < 0 || x >= opt_width || y < 0 || y >= opt_height) {
+                        continue;
+                    }
+                }
+                life.Set(x, y, true);
+            }
+        }
+    });
+}
 
-    for (int i=0; i < width * height; i++) { 
-        pixels[i] = randomInt(0, opt_num_dots - 1) ? 0 : 1;
+void initGameOfLife(LifeEngine &life) {
+
+    life.Clear();
+    glob_num_hashes = glob_hash_pos = 0;
+    glob_rain_new = opt_height;
+
+    // the next pattern of the playlist, or random dots
+    if (!opt_patterns.empty()) {
+        const char *filename = opt_patterns[glob_pattern];
+        glob_pattern = (glob_pattern + 1) % opt_patterns.size();
+        if (loadPattern(life, filename)) return;
+        fprintf(stderr, "Invalid pattern file '%s'\n", filename);
+        life.Clear();
+    }
+    // 1D rules grow from a single cell in the top row
+    if (opt_rule.oneDimensional()) {
+        life.Set(opt_width / 2, 0, true);
+        return;
+    }
+    for (int y=0; y < opt_height; y++) {
+        for (int x=0; x < opt_width; x++) {
+            life.Set(x, y, randomInt(0, opt_num_dots - 1) == 0);
+        }
     }
 
 }
 
-void runGameOfLife(int width, int height, uint8_t pixels[]) {
-    
-    uint8_t pix2[width * height];
-    for (int y=0; y < height; y++) {
-        for (int x=0; x < width; x++) {
-            int n = 0;
-            for (int y1 = y - 1; y1 <= y + 1; y1++) {
-                for (int x1 = x - 1; x1 <= x + 1; x1++) {
-                    if (pixels[ (((y1 + height) % height) * width) + ((x1 + width) % width) ]) {
-                        n++;
-                    }
-                }
-            }
-            if (pixels[y * width + x]) { n--; }
-            pix2[y * width + x] = (n == 3 || (n == 2 && pixels[y * width + x] ));
+// True once the board looks the same as in one of the last opt_period
+// frames: it died (a dead board repeats right away), froze, or is stuck
+// in a cycle such as blinkers. Call once per frame.
+bool stagnated(LifeEngine &life) {
+
+    if (opt_period == 0) return false;
+    const uint64_t h = life.Hash();
+    for (int i=0; i < glob_num_hashes; i++) {
+        if (glob_hashes[i] == h) return true;
+    }
+    glob_hashes[glob_hash_pos] = h;
+    glob_hash_pos = (glob_hash_pos + 1) % opt_period;
+    if (glob_num_hashes < opt_period) glob_num_hashes++;
+    return false;
+}
+
+void runGameOfLife(LifeEngine &life) {
+
+    life.Run();
+    glob_rain_new += opt_steps;
+}
+
+// Color the new rows of a 1D rule, then send the ring of colored rows to
+// the canvas in two spans: from the head to the end of the ring, then
+// from the start of the ring to the head. Older rows keep the color they
+// were given, so nothing scrolls.
+void paintRain(const WolframBoard &board, UDPFlaschenTaschen &canvas,
+               const Color &fg_color, const Color &bg_color) {
+
+    const int head = board.head();
+    const int rows = (glob_rain_new < opt_height) ? glob_rain_new : opt_height;
+    for (int y=0; y < rows; y++) {
+        Color *row = &glob_rain[((head + y) % opt_height) * opt_width];
+        for (int x=0; x < opt_width; x++) {
+            row[x] = board.Get(x, y) ? fg_color : bg_color;
         }
     }
+    glob_rain_new = 0;
 
-    for (int i=0; i < width * height; i++) {
-        pixels[i] = pix2[i];
-    }    
+    const Color *span = &glob_rain[head * opt_width];
+    for (int y=0; y < opt_height; y++) {
+        if (y == opt_height - head) span = &glob_rain[0];
+        for (int x=0; x < opt_width; x++) {
+            canvas.SetPixel(x, y, *span++);
+        }
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -244,11 +443,36 @@ int main(int argc, char *argv[]) {
     UDPFlaschenTaschen canvas(socket, opt_width, opt_height);
     canvas.Clear();
 
-    // pixel buffer
-    uint8_t pixels[ opt_width * opt_height ];
-    for (int i=0; i < opt_width * opt_height; i++) { pixels[i] = 0; }  // clear pixel buffer
+    // either a wrap-around board the size of the display, or HashLife.
+    // other rules than B3/S23 run on the generic engines.
+    LifeEngine *life;
+    ThreadPool *pool = NULL;
+    WolframBoard *rain = NULL;
+    if (opt_rule.oneDimensional()) {
+        rain = new WolframBoard(opt_width, opt_height, opt_rule);
+        rain->SetSteps(opt_steps);
+        glob_rain.resize(opt_width * opt_height);
+        life = rain;
+    } else if (!opt_rule.conway()) {
+        CaBoard *board = new CaBoard(opt_width, opt_height, opt_rule);
+        board->SetSteps(opt_steps);
+        life = board;
+    } else if (opt_hashlife >= 0) {
+        HashLife *hashlife = new HashLife(opt_width, opt_height);
+        hashlife->SetStepLog(opt_hashlife);
+        hashlife->SetZoom(opt_zoom);
+        life = hashlife;
+    } else {
+        LifeBoard *board = new LifeBoard(opt_width, opt_height);
+        board->SetSteps(opt_steps);
+        if (opt_threads != 0) {
+            pool = new ThreadPool(opt_threads);
+            board->SetPool(pool);
+        }
+        life = board;
+    }
 
-    initGameOfLife(opt_width, opt_height, pixels);
+    initGameOfLife(*life);
 
     // handle break
     signal(SIGTERM, InterruptHandler);
@@ -260,29 +484,50 @@ int main(int argc, char *argv[]) {
     time_t respawn_time = starttime;
 
     do {
-        runGameOfLife(opt_width, opt_height, pixels);
+        runGameOfLife(*life);
 
         // check for respawn
         if (opt_respawn > 0) {
             if (difftime(time(NULL), respawn_time) > opt_respawn) {
                 respawn_time = time(NULL);
-                initGameOfLife(opt_width, opt_height, pixels);
+                initGameOfLife(*life);
             }
         }
+        if (stagnated(*life)) {
+            respawn_time = time(NULL);
+            initGameOfLife(*life);
+        }
 
         // set pixel color if cycling through palette
         if (!opt_fgcolor) {
             fg_color = palette[colr];
         }
+        // cells of Generations rules fade from the foreground color to the
+        // background as they die
+        Color colors[CA_MAX_STATES];
+        const int states = life->States();
+        colors[0] = bg_color;
+        colors[1] = fg_color;
+        for (int i=2; i < states; i++) {
+            const float k = (float)(i - 1) / (float)(states - 1);
+            colors[i].r = (uint8_t)(fg_color.r + (bg_color.r - fg_color.r) * k);
+            colors[i].g = (uint8_t)(fg_color.g + (bg_color.g - fg_color.g) * k);
+            colors[i].b = (uint8_t)(fg_color.b + (bg_color.b - fg_color.b) * k);
+        }
 
-        // copy pixel buffer to canvas
-        int dst = 0;
-        for (int y=0; y < opt_height; y++) {
-            for (int x=0; x < opt_width; x++) {
-                canvas.SetPixel( x, y, (pixels[dst] ? fg_color : bg_color) );
-                dst++;
+        // copy board to canvas. with fixed colors only the parts of the
+        // board that changed need repainting, the canvas keeps the rest.
+        if (rain) {
+            paintRain(*rain, canvas, fg_color, bg_color);
+        } else {
+            for (int y=0; y < opt_height; y++) {
+                for (int x=0; x < opt_width; x++) {
+                    if (opt_fgcolor && !life->Changed(x, y)) continue;
+                    canvas.SetPixel( x, y, colors[life->State(x, y)] );
+                }
             }
         }
+        life->ClearChanged();
 
         // send canvas
         canvas.SetOffset(opt_xoff + DISPLAY_XOFF, opt_yoff + DISPLAY_YOFF, opt_layer);
@@ -300,6 +545,8 @@ int main(int argc, char *argv[]) {
     // clear canvas on exit
     canvas.Clear();
     canvas.Send();
+    delete life;
+    delete pool;
 
     if (interrupt_received) return 1;
     return 0;
@@ -42,6 +42,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "glyph-atlas.h"
 
 #include <getopt.h>
 #include <stdio.h>
@@ -53,12 +54,17 @@
 #include <string>
 #include <string.h>
 #include <signal.h>
+#include <vector>
 
 // Defaults
 #define Z_LAYER 2      // (0-15) 0=background
 #define DELAY 50
 #define NUM_DOTS 6
 #define FADE_STEP 8
+#define TRAIL_LENGTH (256 / FADE_STEP)  // rows until a trail has faded out
+#define SPEED 1
+#define GLYPH_TRAIL 12   // glyphs until a trail has faded out
+#define GLYPH_FLICKER 16 // 1 in this many trail glyphs change every frame
 
 volatile bool interrupt_received = false;
 static void InterruptHandler(int signo) {
@@ -81,6 +87,9 @@ bool opt_fgcolor = false, opt_bgcolor = false;
 int opt_fg_R=0, opt_fg_G=255, opt_fg_B=0;  // fg green
 int opt_bg_R=0, opt_bg_G=0, opt_bg_B=0;    // bg transparent
 int opt_num_dots = NUM_DOTS;
+int opt_speed = SPEED;
+bool opt_glyphs = false;
+ft::Font opt_font;
 
 int usage(const char *progname) {
 
@@ -95,6 +104,8 @@ int usage(const char *progname) {
         "\t-d <delay>     : Delay between frames in milliseconds. (default 50)\n"
         "\t-c <RRGGBB>    : Forground color in hex (default green)\n"
         "\t-b <RRGGBB>    : Background color in hex (-b0 = #010101, default transparent)\n"
+        "\t-s <rows>      : Drops fall 1 up to this many rows per frame. (default 1)\n"
+        "\t-f <fontfile>  : Rain glyphs of this *.bdf font instead of pixels.\n"
 //        "\t-n <number>    : Initialize with 1/n random dots. (default 6)\n"
     );
     return 1;
@@ -104,7 +115,7 @@ int cmdLine(int argc, char *argv[]) {
 
     // command line options
     int opt;
-    while ((opt = getopt(argc, argv, "?g:l:t:r:h:d:c:b:n:")) != -1) {
+    while ((opt = getopt(argc, argv, "?g:l:t:r:h:d:c:b:n:s:f:")) != -1) {
         switch (opt) {
         case '?':  // help
             return usage(argv[0]);
@@ -156,6 +167,19 @@ int cmdLine(int argc, char *argv[]) {
             }
             opt_bgcolor = true;
             break;
+        case 's':  // top speed
+            if (sscanf(optarg, "%d", &opt_speed) != 1 || opt_speed < 1) {
+                fprintf(stderr, "Invalid speed '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'f':  // glyph font
+            if (!opt_font.LoadFont(optarg)) {
+                fprintf(stderr, "Couldn't load font '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_glyphs = true;
+            break;
         case 'n':  // init with 1/n number of dots (REMOVE)
             if (sscanf(optarg, "%d", &opt_num_dots) != 1 || opt_num_dots < 2) {
                 fprintf(stderr, "Invalid number of dots '%s'\n", optarg);
@@ -186,25 +210,123 @@ void colorGradient(int start, int end, int r1, int g1, int b1, int r2, int g2, i
     }
 }
 
-void runMatrix(int width, int height, uint8_t pixels[]) {
+// A falling white (255) head, and the trail behind it fading out over
+// 'length' rows. The head may be below the bottom while the trail is
+// still on screen.
+struct Drop {
+    int x;
+    int head;      // row
+    int speed;     // rows per frame
+    int length;
+    int top;       // first row drawn last frame
+};
+
+// brightness 'k' rows behind the head, 255 at the head down to 0 at 'length'
+static inline int trailValue(int k, int length) {
+    const int v = 255 - (k * 256 + length - 1) / length;
+    return (v > 0) ? v : 0;
+}
 
-    int pmax = width * height - 1;
-    int temp=0;
-    for (int i=pmax; i >= 0; i--) {
-        // copy white (255) pixel down one row
-        if ((pixels[i] == 255) && (i + width <= pmax)) {
-            pixels[i + width] = 255;
+// Move every drop down and redraw its trail. Only the rows of the trails,
+// and of where they were last frame, are touched, so this costs as much as
+// there are drops, not pixels. Each drop's rows from 'top' down to its head
+// are the ones that may have changed.
+void runMatrix(int width, int height, uint8_t pixels[], std::vector<Drop> &drops) {
+
+    // clear the old trails, then draw the new ones. A column with several
+    // drops shows the brightest, so they're drawn with max().
+    for (size_t i=0; i < drops.size(); i++) {
+        Drop &d = drops[i];
+        const int bottom = (d.head < height) ? d.head : height - 1;
+        for (int y=d.top; y <= bottom; y++) { pixels[y * width + d.x] = 0; }
+        d.head += d.speed;
+    }
+    for (size_t i=0; i < drops.size(); i++) {
+        const Drop &d = drops[i];
+        const int top = (d.head - d.length + 1 > 0) ? d.head - d.length + 1 : 0;
+        const int bottom = (d.head < height) ? d.head : height - 1;
+        for (int y=top; y <= bottom; y++) {
+            uint8_t &p = pixels[y * width + d.x];
+            const int v = trailValue(d.head - y, d.length);
+            if (v > p) p = v;
         }
-        // fade pixel by FADE_STEP
-        temp = (int)pixels[i] - FADE_STEP;
-        pixels[i] = (temp > 0) ? (uint8_t)temp : 0;
     }
 }
 
-void drawRainPixel(int width, int height, uint8_t pixels[]) {
+// after painting: forget drops whose trail is gone, and remember where
+// the others start
+void retireDrops(int height, std::vector<Drop> &drops) {
+
+    size_t n = 0;
+    for (size_t i=0; i < drops.size(); i++) {
+        Drop d = drops[i];
+        if (d.head - d.length + 1 >= height) continue;
+        d.top = (d.head - d.length + 1 > 0) ? d.head - d.length + 1 : 0;
+        drops[n++] = d;
+    }
+    drops.resize(n);
+}
+
+void addDrop(int width, int length, std::vector<Drop> &drops) {
+
+    Drop d;
+    d.x = randomInt(0, width - 1);
+    d.head = 0;
+    d.speed = randomInt(1, opt_speed);
+    d.length = length;
+    d.top = 0;
+    drops.push_back(d);
+}
+
+// ------------------------------------------------------------------------------------------
+// Glyph rain. The same drops fall through a grid of glyph cells, one
+// pixel apart, with the brightness of each cell in 'pixels'.
+
+// the glyphs to rain, those the font doesn't have are left out
+const uint32_t kGlyphs[] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+    'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+    ':', '.', '=', '*', '+', '-', '<', '>', '|', '"',
+    // half-width katakana
+    0xFF66, 0xFF67, 0xFF68, 0xFF69, 0xFF6A, 0xFF6B, 0xFF6C, 0xFF6D, 0xFF6E, 0xFF6F,
+    0xFF70, 0xFF71, 0xFF72, 0xFF73, 0xFF74, 0xFF75, 0xFF76, 0xFF77, 0xFF78, 0xFF79,
+    0xFF7A, 0xFF7B, 0xFF7C, 0xFF7D, 0xFF7E, 0xFF7F, 0xFF80, 0xFF81, 0xFF82, 0xFF83,
+    0xFF84, 0xFF85, 0xFF86, 0xFF87, 0xFF88, 0xFF89, 0xFF8A, 0xFF8B, 0xFF8C, 0xFF8D,
+    0xFF8E, 0xFF8F, 0xFF90, 0xFF91, 0xFF92, 0xFF93, 0xFF94, 0xFF95, 0xFF96, 0xFF97,
+    0xFF98, 0xFF99, 0xFF9A, 0xFF9B, 0xFF9C, 0xFF9D,
+};
+
+// copy a glyph onto the canvas at cell x, y with brightness 'value'
+void drawGlyph(UDPFlaschenTaschen &canvas, const GlyphAtlas &atlas, int glyph,
+               int x, int y, int value, const Color palette[]) {
+
+    const uint8_t *alpha = atlas.Glyph(glyph);
+    const int x0 = x * (atlas.width() + 1), y0 = y * atlas.height();
+    for (int gy=0; gy < atlas.height() && y0 + gy < opt_height; gy++) {
+        for (int gx=0; gx < atlas.width() && x0 + gx < opt_width; gx++) {
+            canvas.SetPixel( x0 + gx, y0 + gy, palette[alpha[gy * atlas.width() + gx] * value / 255] );
+        }
+    }
+}
 
-    int p = randomInt(0, width - 1);
-    pixels[p] = 255;
+// Draw the cells of each drop's span. The head gets a new glyph, and
+// some of the trail flickers to new ones.
+void drawGlyphDrops(UDPFlaschenTaschen &canvas, const GlyphAtlas &atlas, int cols, int rows,
+                    const uint8_t pixels[], uint16_t glyphs[], const std::vector<Drop> &drops,
+                    const Color palette[]) {
+
+    for (size_t i=0; i < drops.size(); i++) {
+        const Drop &d = drops[i];
+        const int bottom = (d.head < rows) ? d.head : rows - 1;
+        for (int y=d.top; y <= bottom; y++) {
+            const int c = y * cols + d.x;
+            if (y == d.head || (pixels[c] > 0 && randomInt(1, GLYPH_FLICKER) == 1)) {
+                glyphs[c] = randomInt(0, atlas.count() - 1);
+            }
+            drawGlyph(canvas, atlas, glyphs[c], d.x, y, pixels[c], palette);
+        }
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -226,9 +348,31 @@ int main(int argc, char *argv[]) {
     UDPFlaschenTaschen canvas(socket, opt_width, opt_height);
     canvas.Clear();
 
-    // pixel buffer
-    uint8_t pixels[ opt_width * opt_height ];
-    for (int i=0; i < opt_width * opt_height; i++) { pixels[i] = 0; }  // clear pixel buffer
+    // the glyphs are drawn once up front, the grid is of glyph cells
+    GlyphAtlas atlas;
+    int cols = opt_width, rows = opt_height;
+    int trail = TRAIL_LENGTH;
+    if (opt_glyphs) {
+        if (!atlas.Build(opt_font, kGlyphs, sizeof(kGlyphs) / sizeof(kGlyphs[0]))) {
+            fprintf(stderr, "Font has none of the glyphs to rain\n");
+            return 1;
+        }
+        cols = (opt_width + 1) / (atlas.width() + 1);
+        rows = (opt_height + atlas.height() - 1) / atlas.height();
+        trail = GLYPH_TRAIL;
+        if (cols < 1) {
+            fprintf(stderr, "Font is too wide for a %d pixel display\n", opt_width);
+            return 1;
+        }
+    }
+
+    // pixel buffer, or cell buffer for glyphs
+    uint8_t pixels[ cols * rows ];
+    for (int i=0; i < cols * rows; i++) { pixels[i] = 0; }  // clear pixel buffer
+    std::vector<uint16_t> glyphs(cols * rows);
+    for (int i=0; i < cols * rows && opt_glyphs; i++) { glyphs[i] = randomInt(0, atlas.count() - 1); }
+    std::vector<Drop> drops;
+    canvas.Fill(palette[0]);
 
     // handle break
     signal(SIGTERM, InterruptHandler);
@@ -241,10 +385,10 @@ int main(int argc, char *argv[]) {
 
     do {
         if (count % 4 == 0) {
-            drawRainPixel(opt_width, opt_height, pixels);
+            addDrop(cols, trail, drops);
         }
 
-        runMatrix(opt_width, opt_height, pixels);
+        runMatrix(cols, rows, pixels, drops);
 
         // check for respawn (REMOVE LATER?)
         if (opt_respawn > 0) {
@@ -253,14 +397,20 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        // copy pixel buffer to canvas
-        int dst = 0;
-        for (int y=0; y < opt_height; y++) {
-            for (int x=0; x < opt_width; x++) {
-                canvas.SetPixel( x, y, palette[pixels[dst]] );
-                dst++;
+        // copy the changed column spans to canvas, from the top of the old
+        // trail down to the head
+        if (opt_glyphs) {
+            drawGlyphDrops(canvas, atlas, cols, rows, pixels, &glyphs[0], drops, palette);
+        } else {
+            for (size_t i=0; i < drops.size(); i++) {
+                const Drop &d = drops[i];
+                const int bottom = (d.head < opt_height) ? d.head : opt_height - 1;
+                for (int y=d.top; y <= bottom; y++) {
+                    canvas.SetPixel( d.x, y, palette[pixels[y * opt_width + d.x]] );
+                }
             }
         }
+        retireDrops(rows, drops);
 
         // send canvas
         canvas.SetOffset(opt_xoff + DISPLAY_XOFF, opt_yoff + DISPLAY_YOFF, opt_layer);
@@ -0,0 +1,441 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// maze-gen.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Maze generators that carve a little at a time, so the maze can be
+// watched growing. They all draw into the same pixel grid: cells are the
+// pixels at even x and y, and the wall between two neighbouring cells is
+// the pixel between them. Cells and walls being worked on are drawn as
+// kColorMaze, finished ones as kColorVisited.
+//
+//   DfsMaze      depth-first search with backtracking, long winding paths
+//   WilsonMaze   loop-erased random walks, an unbiased pick of all mazes
+//   KruskalMaze  joins random cells all over, using union-find
+//   PrimMaze     grows outwards from one cell
+//   EllerMaze    one row at a time, endlessly, scrolling up the display
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef MAZE_GEN_H
+#define MAZE_GEN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stack>
+#include <vector>
+
+const int kColorBG = 0;
+const int kColorMaze = 1;
+const int kColorVisited = 2;
+
+struct Position {
+    Position() {}
+    Position(int xx, int yy) : x(xx), y(yy) {}
+    int x;
+    int y;
+};
+
+// The cells and walls of a maze in a px_width x px_height pixel grid.
+class MazeGrid {
+public:
+    MazeGrid(int px_width, int px_height, uint8_t *pixels)
+        : px_width_(px_width), px_height_(px_height),
+          width_((px_width + 1) / 2), height_((px_height + 1) / 2), pixels_(pixels) {}
+
+    int cells() const { return width_ * height_; }
+
+protected:
+    static int RandomBelow(int n) { return random() % n; }
+
+    // cells are numbered row by row
+    int Index(Position p) const { return p.y * width_ + p.x; }
+    Position At(int i) const { return Position(i % width_, i / width_); }
+
+    uint8_t &Cell(Position p) { return pixels_[(p.y * 2 * px_width_) + (p.x * 2)]; }
+    // it's really the mid-point between the two cells
+    uint8_t &Wall(Position a, Position b) { return pixels_[((a.y + b.y) * px_width_) + (a.x + b.x)]; }
+
+    // the up to 4 neighbours of p inside the maze
+    int Neighbours(Position p, Position out[4]) const {
+        int n = 0;
+        if (p.y > 0) { out[n++] = Position(p.x, p.y - 1); }
+        if (p.y < height_ - 1) { out[n++] = Position(p.x, p.y + 1); }
+        if (p.x > 0) { out[n++] = Position(p.x - 1, p.y); }
+        if (p.x < width_ - 1) { out[n++] = Position(p.x + 1, p.y); }
+        return n;
+    }
+
+    int px_width_, px_height_;
+    int width_, height_;   // in cells
+    uint8_t *pixels_;
+};
+
+class MazeGenerator : public MazeGrid {
+public:
+    // 'pixels' is px_width x px_height, and all kColorBG to start with
+    MazeGenerator(int px_width, int px_height, uint8_t *pixels)
+        : MazeGrid(px_width, px_height, pixels) {}
+    virtual ~MazeGenerator() {}
+
+    // Carve one more cell. False once the maze is finished.
+    virtual bool Step() = 0;
+
+    // How much of the maze is done, 0 to 1, or -1 if it never ends.
+    virtual double Progress() const { return -1; }
+};
+
+/*
+    Using the simple Depth-first search algorithm.
+
+    1. Start at a random cell.
+    2. Mark the current cell as visited, and get a list of its neighbors.
+       For each neighbor, starting with a randomly selected neighbor:
+    3. If that neighbor hasn't been visited, remove the wall between this cell and that neighbor,
+       and then recurse with that neighbor as the current cell.
+
+    NOTE: Using a stack instead of recursion to make use of the main() event loop.
+*/
+class DfsMaze : public MazeGenerator {
+public:
+    DfsMaze(int px_width, int px_height, uint8_t *pixels)
+        : MazeGenerator(px_width, px_height, pixels), steps_(0) {
+        cell_stack_.push(Position(RandomBelow(width_), RandomBelow(height_)));
+    }
+
+    // every cell is pushed once and popped once
+    virtual double Progress() const { return (steps_ + 1) / (2.0 * cells()); }
+
+    virtual bool Step() {
+        if (cell_stack_.empty()) return false;
+        Position pos = cell_stack_.top();
+        steps_++;
+
+        // mark current pos as forground
+        Cell(pos) = kColorMaze;
+
+        // create list of neighbors not yet visited
+        Position all[4], neighbor[4];
+        int n = 0;
+        const int count = Neighbours(pos, all);
+        for (int i=0; i < count; i++) {
+            if (Cell(all[i]) == kColorBG) { neighbor[n++] = all[i]; }
+        }
+
+        // pick a random neighbor
+        if (n > 0) {
+            Position next = neighbor[RandomBelow(n)];
+            Wall(pos, next) = kColorMaze;
+            cell_stack_.push(next);
+        } else {
+            // no neighbors left
+            // mark pos as visited then pop off stack
+            Cell(pos) = kColorVisited;
+            cell_stack_.pop();
+
+            // draw visited wall
+            if (!cell_stack_.empty()) {
+                Wall(pos, cell_stack_.top()) = kColorVisited;
+            }
+        }
+        return true;
+    }
+
+private:
+    int steps_;
+    std::stack<Position> cell_stack_;
+};
+
+// Random walks from a cell outside the maze until they hit it. Where a
+// walk crosses itself the loop is erased, and once it reaches the maze
+// the walk becomes part of it.
+class WilsonMaze : public MazeGenerator {
+public:
+    WilsonMaze(int px_width, int px_height, uint8_t *pixels)
+        : MazeGenerator(px_width, px_height, pixels), next_start_(0), done_(1),
+          in_maze_(width_ * height_, 0), on_walk_(width_ * height_, -1) {
+        const Position start = At(RandomBelow(width_ * height_));
+        in_maze_[Index(start)] = 1;
+        Cell(start) = kColorVisited;
+    }
+
+    // the first walks take the longest, so this speeds up towards the end
+    virtual double Progress() const { return (double)done_ / cells(); }
+
+    virtual bool Step() {
+        if (walk_.empty()) {
+            // start a walk from the next cell not in the maze yet
+            while (next_start_ < width_ * height_ && in_maze_[next_start_]) { next_start_++; }
+            if (next_start_ == width_ * height_) return false;
+            AddToWalk(At(next_start_));
+            return true;
+        }
+
+        Position neighbor[4];
+        const Position pos = At(walk_.back());
+        const Position next = neighbor[RandomBelow(Neighbours(pos, neighbor))];
+        const int i = Index(next);
+        if (in_maze_[i]) {
+            // the walk joins the maze
+            Wall(pos, next) = kColorVisited;
+            for (size_t k=0; k < walk_.size(); k++) {
+                const Position p = At(walk_[k]);
+                if (k > 0) { Wall(At(walk_[k - 1]), p) = kColorVisited; }
+                Cell(p) = kColorVisited;
+                in_maze_[walk_[k]] = 1;
+                on_walk_[walk_[k]] = -1;
+            }
+            done_ += walk_.size();
+            walk_.clear();
+        } else if (on_walk_[i] >= 0) {
+            // erase the loop back to where the walk was at 'next' before
+            while ((int)walk_.size() > on_walk_[i] + 1) {
+                const int last = walk_.back();
+                walk_.pop_back();
+                Cell(At(last)) = kColorBG;
+                Wall(At(walk_.back()), At(last)) = kColorBG;
+                on_walk_[last] = -1;
+            }
+        } else {
+            Wall(pos, next) = kColorMaze;
+            AddToWalk(next);
+        }
+        return true;
+    }
+
+private:
+    void AddToWalk(Position p) {
+        on_walk_[Index(p)] = walk_.size();
+        walk_.push_back(Index(p));
+        Cell(p) = kColorMaze;
+    }
+
+    int next_start_;
+    int done_;                   // cells in the maze
+    std::vector<uint8_t> in_maze_;
+    std::vector<int> on_walk_;   // position in walk_, or -1
+    std::vector<int> walk_;
+};
+
+// Takes the walls in random order, and removes each one that separates
+// two cells not connected yet. Which cells are connected is kept in a
+// union-find forest.
+class KruskalMaze : public MazeGenerator {
+public:
+    KruskalMaze(int px_width, int px_height, uint8_t *pixels)
+        : MazeGenerator(px_width, px_height, pixels), next_(0), joined_(0),
+          parent_(width_ * height_), size_(width_ * height_, 1) {
+        // walls to the right (even) and below (odd) every cell, shuffled
+        for (int i=0; i < width_ * height_; i++) {
+            const Position p = At(i);
+            parent_[i] = i;
+            Cell(p) = kColorMaze;
+            if (p.x < width_ - 1) walls_.push_back(i * 2);
+            if (p.y < height_ - 1) walls_.push_back(i * 2 + 1);
+        }
+        if (walls_.empty()) Cell(At(0)) = kColorVisited;   // a maze of one cell
+        for (int i=(int)walls_.size() - 1; i > 0; i--) {
+            const int j = RandomBelow(i + 1);
+            const int t = walls_[i];
+            walls_[i] = walls_[j];
+            walls_[j] = t;
+        }
+    }
+
+    virtual bool Step() {
+        while (next_ < walls_.size()) {
+            const int a = walls_[next_] / 2;
+            const int b = (walls_[next_] & 1) ? a + width_ : a + 1;
+            next_++;
+            int ra = Find(a), rb = Find(b);
+            if (ra == rb) continue;
+            // the smaller tree goes under the bigger one
+            if (size_[ra] < size_[rb]) {
+                const int t = ra;
+                ra = rb;
+                rb = t;
+            }
+            parent_[rb] = ra;
+            size_[ra] += size_[rb];
+            joined_++;
+            Cell(At(a)) = Cell(At(b)) = Wall(At(a), At(b)) = kColorVisited;
+            return true;
+        }
+        return false;
+    }
+
+    // a maze of n cells takes n-1 joins
+    virtual double Progress() const { return (cells() > 1) ? (double)joined_ / (cells() - 1) : 1; }
+
+private:
+    int Find(int i) {
+        while (parent_[i] != i) {
+            // path halving: point every other cell on the way at its grandparent
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    size_t next_;
+    int joined_;
+    std::vector<int> walls_;
+    std::vector<int> parent_;
+    std::vector<int> size_;
+};
+
+// Grows the maze from one cell, every step connecting a random cell of
+// its frontier (cells next to the maze) to the maze.
+class PrimMaze : public MazeGenerator {
+public:
+    PrimMaze(int px_width, int px_height, uint8_t *pixels)
+        : MazeGenerator(px_width, px_height, pixels), added_(0), state_(width_ * height_, OUTSIDE) {
+        AddToMaze(At(RandomBelow(width_ * height_)));
+    }
+
+    virtual double Progress() const { return (double)added_ / cells(); }
+
+    virtual bool Step() {
+        if (frontier_.empty()) return false;
+        const int k = RandomBelow(frontier_.size());
+        const Position pos = At(frontier_[k]);
+        frontier_[k] = frontier_.back();
+        frontier_.pop_back();
+
+        // connect to a random neighbour already in the maze
+        Position neighbor[4], in[4];
+        const int count = Neighbours(pos, neighbor);
+        int n = 0;
+        for (int i=0; i < count; i++) {
+            if (state_[Index(neighbor[i])] == IN_MAZE) { in[n++] = neighbor[i]; }
+        }
+        Wall(pos, in[RandomBelow(n)]) = kColorVisited;
+        AddToMaze(pos);
+        return true;
+    }
+
+private:
+    enum { OUTSIDE, FRONTIER, IN_MAZE };
+
+    void AddToMaze(Position pos) {
+        added_++;
+        state_[Index(pos)] = IN_MAZE;
+        Cell(pos) = kColorVisited;
+        Position neighbor[4];
+        const int count = Neighbours(pos, neighbor);
+        for (int i=0; i < count; i++) {
+            const int j = Index(neighbor[i]);
+            if (state_[j] != OUTSIDE) continue;
+            state_[j] = FRONTIER;
+            frontier_.push_back(j);
+            Cell(neighbor[i]) = kColorMaze;
+        }
+    }
+
+    int added_;
+    std::vector<uint8_t> state_;
+    std::vector<int> frontier_;
+};
+
+// Eller's algorithm makes the maze one row at a time and only has to
+// remember which cells of the current row are connected (their set), so
+// it never has to end. Each row is carved at the bottom of the display,
+// then everything scrolls up by one row of cells.
+//
+// Along a row, neighbouring cells of different sets are joined at random.
+// Then every set gets at least one passage down, which the next row's
+// cells inherit the set through; the others start sets of their own.
+class EllerMaze : public MazeGenerator {
+public:
+    EllerMaze(int px_width, int px_height, uint8_t *pixels)
+        : MazeGenerator(px_width, px_height, pixels), x_(0),
+          set_(width_), down_(width_, 0), used_(width_, 0) {}
+
+    virtual bool Step() {
+        if (x_ == 0) NewRow();
+        const int y = px_height_ - 1;
+        Cell(x_, y) = kColorMaze;
+        if (x_ > 0 && set_[x_ - 1] != set_[x_] && RandomBelow(2)) {
+            // join the two sets
+            const int from = set_[x_];
+            for (int i=0; i < width_; i++) {
+                if (set_[i] == from) set_[i] = set_[x_ - 1];
+            }
+            pixels_[y * px_width_ + x_ * 2 - 1] = kColorMaze;
+        }
+        if (++x_ == width_) {
+            EndRow();
+            x_ = 0;
+        }
+        return true;
+    }
+
+private:
+    uint8_t &Cell(int x, int y) { return pixels_[y * px_width_ + x * 2]; }
+
+    // scroll up and give every cell of the new row a set. A display one
+    // pixel high has no room for passages down, its row is just replaced.
+    void NewRow() {
+        const int keep = (px_height_ > 2) ? px_height_ - 2 : 0;
+        memmove(pixels_, pixels_ + (px_height_ - keep) * px_width_, keep * px_width_);
+        memset(pixels_ + keep * px_width_, kColorBG, (px_height_ - keep) * px_width_);
+
+        // cells below a passage down stay in the set above
+        memset(&used_[0], 0, width_);
+        for (int i=0; i < width_; i++) {
+            if (down_[i]) {
+                used_[set_[i]] = 1;
+                if (px_height_ >= 2) pixels_[(px_height_ - 2) * px_width_ + i * 2] = kColorVisited;
+            }
+        }
+        int free_set = 0;
+        for (int i=0; i < width_; i++) {
+            if (down_[i]) continue;
+            while (used_[free_set]) { free_set++; }
+            set_[i] = free_set;
+            used_[free_set] = 1;
+        }
+    }
+
+    // passages down, and the row is done
+    void EndRow() {
+        for (int i=0; i < width_; i++) { down_[i] = RandomBelow(2); }
+        // used_ now means: this set has a passage down
+        memset(&used_[0], 0, width_);
+        for (int i=0; i < width_; i++) {
+            if (down_[i]) used_[set_[i]] = 1;
+        }
+        // a set without one gets its last cell connected
+        for (int i=width_ - 1; i >= 0; i--) {
+            if (!used_[set_[i]]) {
+                down_[i] = 1;
+                used_[set_[i]] = 1;
+            }
+        }
+        uint8_t *row = pixels_ + (px_height_ - 1) * px_width_;
+        for (int x=0; x < px_width_; x++) {
+            if (row[x] != kColorBG) row[x] = kColorVisited;
+        }
+    }
+
+    int x_;                        // next cell of the row
+    std::vector<int> set_;         // set of each cell of the row, 0 to width_-1
+    std::vector<uint8_t> down_;    // passage down from each cell
+    std::vector<uint8_t> used_;    // by set
+};
+
+#endif  // MAZE_GEN_H
@@ -0,0 +1,178 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// maze-solve.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// Solves a finished maze from maze-gen.h, from the top left cell to the
+// bottom right one, a few cells at a time so it can be watched:
+//
+//   BFS            breadth-first search, spreads out evenly from the start
+//   ASTAR          A*, heads for the goal guided by the manhattan distance
+//   WALL_FOLLOWER  keeps its left hand on the wall
+//
+// Cells the search has reached are drawn as kColorFrontier. Once the goal
+// is found, the path back to the start is drawn as kColorPath.
+//
+// The mazes are perfect (one way between any two cells), so every cell is
+// reached once at most, and all the memory is allocated up front: a bitmap
+// of reached cells, the direction back to where each was reached from, and
+// a queue or heap that can hold every cell.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef MAZE_SOLVE_H
+#define MAZE_SOLVE_H
+
+#include "maze-gen.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+const int kColorFrontier = 3;
+const int kColorPath = 4;
+
+class MazeSolver : public MazeGrid {
+public:
+    enum Algorithm { BFS, ASTAR, WALL_FOLLOWER };
+
+    MazeSolver(int px_width, int px_height, uint8_t *pixels, Algorithm algorithm)
+        : MazeGrid(px_width, px_height, pixels), algorithm_(algorithm),
+          goal_(width_ * height_ - 1), trace_(-1), pos_(0), dir_(RIGHT),
+          reached_((width_ * height_ + 63) / 64, 0), back_(width_ * height_, NONE),
+          queue_(algorithm == BFS ? width_ * height_ : 0), head_(0), tail_(0) {
+        if (algorithm_ == ASTAR) {
+            distance_.resize(width_ * height_);
+            heap_.reserve(width_ * height_);
+        }
+        Reach(0, NONE);
+    }
+
+    // Up to 'steps' more cells searched or path drawn. False once solved.
+    bool Step(int steps) {
+        for (int i=0; i < steps; i++) {
+            if (trace_ >= 0) {
+                if (!Trace()) return false;
+            } else {
+                const int pos = Search();
+                if (pos == goal_) {
+                    trace_ = goal_;
+                } else if (pos < 0) {
+                    return false;   // not connected, nothing to draw
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    enum { UP, RIGHT, DOWN, LEFT, NONE };
+
+    struct Node {
+        int f, h, cell;
+        // the heap keeps the largest on top, so the order is reversed
+        bool operator<(const Node &o) const { return f > o.f || (f == o.f && h > o.h); }
+    };
+
+    bool Reached(int i) const { return (reached_[i >> 6] >> (i & 63)) & 1; }
+
+    // the cell next to i in direction d, or -1 if there's a wall
+    int Next(int i, int d) const {
+        static const int dx[4] = { 0, 1, 0, -1 }, dy[4] = { -1, 0, 1, 0 };
+        const Position p = At(i);
+        const int x = p.x + dx[d], y = p.y + dy[d];
+        if (x < 0 || x >= width_ || y < 0 || y >= height_) return -1;
+        if (pixels_[(p.y * 2 + dy[d]) * px_width_ + p.x * 2 + dx[d]] == kColorBG) return -1;
+        return y * width_ + x;
+    }
+
+    // mark i reached, coming from direction 'from' of it
+    void Reach(int i, int from) {
+        reached_[i >> 6] |= 1ULL << (i & 63);
+        back_[i] = from;
+        Cell(At(i)) = kColorFrontier;
+        if (from != NONE) Wall(At(i), At(Next(i, from))) = kColorFrontier;
+
+        if (algorithm_ == ASTAR) {
+            const Position p = At(i), goal = At(goal_);
+            distance_[i] = (from == NONE) ? 0 : distance_[Next(i, from)] + 1;
+            Node node;
+            node.h = (goal.x - p.x) + (goal.y - p.y);
+            node.f = distance_[i] + node.h;
+            node.cell = i;
+            heap_.push_back(node);
+            std::push_heap(heap_.begin(), heap_.end());
+        } else if (algorithm_ == BFS) {
+            queue_[tail_++] = i;
+        }
+    }
+
+    // Expand one more cell and return it, or -1 when there are none left.
+    int Search() {
+        int pos;
+        if (algorithm_ == WALL_FOLLOWER) {
+            // try left, straight on, right, then back
+            for (int turn=3; turn < 7; turn++) {
+                const int d = (dir_ + turn) & 3;
+                const int next = Next(pos_, d);
+                if (next < 0) continue;
+                dir_ = d;
+                if (!Reached(next)) Reach(next, d ^ 2);
+                return pos_ = next;
+            }
+            return (pos_ == goal_) ? pos_ : -1;   // a maze of one cell
+        }
+        if (algorithm_ == ASTAR) {
+            if (heap_.empty()) return -1;
+            std::pop_heap(heap_.begin(), heap_.end());
+            pos = heap_.back().cell;
+            heap_.pop_back();
+        } else {
+            if (head_ == tail_) return -1;
+            pos = queue_[head_++];
+        }
+        if (pos == goal_) return pos;
+        for (int d=0; d < 4; d++) {
+            const int next = Next(pos, d);
+            if (next >= 0 && !Reached(next)) Reach(next, d ^ 2);
+        }
+        return pos;
+    }
+
+    // draw one more cell of the path. False once back at the start.
+    bool Trace() {
+        Cell(At(trace_)) = kColorPath;
+        if (back_[trace_] == NONE) return false;
+        const int next = Next(trace_, back_[trace_]);
+        Wall(At(trace_), At(next)) = kColorPath;
+        trace_ = next;
+        return true;
+    }
+
+    Algorithm algorithm_;
+    int goal_;
+    int trace_;                    // path drawn back to here, -1 while searching
+    int pos_, dir_;                // wall follower's cell and heading
+    std::vector<uint64_t> reached_;
+    std::vector<uint8_t> back_;    // direction to the cell each was reached from
+    std::vector<int> queue_;       // BFS
+    int head_, tail_;
+    std::vector<int> distance_;    // A* steps from the start
+    std::vector<Node> heap_;       // A* open cells
+};
+
+#endif  // MAZE_SOLVE_H
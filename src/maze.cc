@@ -40,6 +40,9 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "frame-timer.h"
+#include "maze-gen.h"
+#include "maze-solve.h"
 
 #include <getopt.h>
 #include <stdio.h>
@@ -47,32 +50,23 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <limits.h>
+#include <math.h>
 #include <time.h>
 #include <string>
 #include <string.h>
 #include <signal.h>
-#include <stack>
 
 // Defaults
 #define Z_LAYER 2      // (0-15) 0=background
 #define DELAY 20
-
-struct Position {
-    Position() {}
-    Position(int xx, int yy) : x(xx), y(yy) {}
-    int x;
-    int y;
-};
+#define FINISH_TIME 30 // seconds to carve a maze in
+#define SOLVE_TIME 10  // seconds a solve takes, unless -e is given
 
 volatile bool interrupt_received = false;
 static void InterruptHandler(int signo) {
     interrupt_received = true;
 }
 
-const int kColorBG = 0;
-const int kColorMaze = 1;
-const int kColorVisited = 2;
-
 // ------------------------------------------------------------------------------------------
 // Command Line Options
 
@@ -84,10 +78,16 @@ int opt_width  = DISPLAY_WIDTH;
 int opt_height = DISPLAY_HEIGHT;
 int opt_xoff=0, opt_yoff=0;
 int opt_delay  = DELAY;
+double opt_finish = FINISH_TIME;
 bool opt_fgcolor = false, opt_bgcolor = false, opt_vcolor = false;
 int opt_fg_R=0xFF, opt_fg_G=0xFF, opt_fg_B=0xFF;
 int opt_vc_R=0, opt_vc_G=0, opt_vc_B=0;
 int opt_bg_R=0, opt_bg_G=0, opt_bg_B=0;
+int opt_fr_R=0x30, opt_fr_G=0x30, opt_fr_B=0x80;
+int opt_pa_R=0xFF, opt_pa_G=0, opt_pa_B=0;
+const char *opt_algorithm = "dfs";
+const char *opt_solver = "bfs";
+int opt_expansions = 0;
 
 int usage(const char *progname) {
 
@@ -99,9 +99,17 @@ int usage(const char *progname) {
         "\t-t <timeout>   : Timeout exits after given seconds. (default 24hrs)\n"
         "\t-h <host>      : Flaschen-Taschen display hostname. (FT_DISPLAY)\n"
         "\t-d <delay>     : Delay between frames in milliseconds. (default 20)\n"
+        "\t-T <seconds>   : Carve each maze in about this long, at least one cell a frame.\n"
+        "\t                 -T0 = as fast as the frames allow. (default 30)\n"
         "\t-c <RRGGBB>    : Maze color in hex (-c0 = transparent, default white)\n"
         "\t-v <RRGGBB>    : Visited color in hex (-v0 = transparent, default cycles)\n"
         "\t-b <RRGGBB>    : Background color in hex (-b0 = #010101, default transparent)\n"
+        "\t-a <algorithm> : dfs, wilson, kruskal, prim, or eller. (default dfs)\n"
+        "\t                 eller never ends, it scrolls up endlessly.\n"
+        "\t-s <solver>    : Solve the finished maze with bfs, astar, wall or none. (default bfs)\n"
+        "\t-e <cells>     : Cells the solver searches per frame. (default: solves in 10 secs)\n"
+        "\t-f <RRGGBB>    : Searched color in hex (-f0 = transparent, default 303080)\n"
+        "\t-p <RRGGBB>    : Path color in hex (-p0 = transparent, default red)\n"
     );
     return 1;
 }
@@ -110,7 +118,7 @@ int cmdLine(int argc, char *argv[]) {
 
     // command line options
     int opt;
-    while ((opt = getopt(argc, argv, "?g:l:t:h:d:c:v:b:")) != -1) {
+    while ((opt = getopt(argc, argv, "?g:l:t:h:d:T:c:v:b:a:s:e:f:p:")) != -1) {
         switch (opt) {
         case '?':  // help
             return usage(argv[0]);
@@ -142,6 +150,12 @@ int cmdLine(int argc, char *argv[]) {
                 return usage(argv[0]);
             }
             break;
+        case 'T':  // time to carve a maze in
+            if (sscanf(optarg, "%lf", &opt_finish) != 1 || opt_finish < 0) {
+                fprintf(stderr, "Invalid carving time '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
         case 'c':  // initial maze color
             if (sscanf(optarg, "%02x%02x%02x", &opt_fg_R, &opt_fg_G, &opt_fg_B) != 3) {
                 opt_fg_R=0, opt_fg_G=0, opt_fg_B=0;
@@ -160,6 +174,38 @@ int cmdLine(int argc, char *argv[]) {
             }
             opt_bgcolor = true;
             break;
+        case 'a':  // algorithm
+            if (strcmp(optarg, "dfs") && strcmp(optarg, "wilson") && strcmp(optarg, "kruskal") &&
+                strcmp(optarg, "prim") && strcmp(optarg, "eller")) {
+                fprintf(stderr, "Invalid algorithm '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_algorithm = strdup(optarg); // leaking. Ignore.
+            break;
+        case 's':  // solver
+            if (strcmp(optarg, "bfs") && strcmp(optarg, "astar") && strcmp(optarg, "wall") &&
+                strcmp(optarg, "none")) {
+                fprintf(stderr, "Invalid solver '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            opt_solver = strdup(optarg); // leaking. Ignore.
+            break;
+        case 'e':  // solver cells per frame
+            if (sscanf(optarg, "%d", &opt_expansions) != 1 || opt_expansions < 1) {
+                fprintf(stderr, "Invalid cells per frame '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'f':  // searched color
+            if (sscanf(optarg, "%02x%02x%02x", &opt_fr_R, &opt_fr_G, &opt_fr_B) != 3) {
+                opt_fr_R=0, opt_fr_G=0, opt_fr_B=0;
+            }
+            break;
+        case 'p':  // path color
+            if (sscanf(optarg, "%02x%02x%02x", &opt_pa_R, &opt_pa_G, &opt_pa_B) != 3) {
+                opt_pa_R=0, opt_pa_G=0, opt_pa_B=0;
+            }
+            break;
         default:
             return usage(argv[0]);
         }
@@ -184,92 +230,58 @@ void colorGradient(int start, int end, int r1, int g1, int b1, int r2, int g2, i
     }
 }
 
-void clearArray( const int width, const int height, uint8_t some_array[] ) {
+MazeGenerator *newMaze(const char *algorithm, int px_width, int px_height, uint8_t pixels[]) {
 
-    for (int i=0; i < width * height; i++) { 
-        some_array[i] = 0;
-    }
+    if (strcmp(algorithm, "wilson") == 0) return new WilsonMaze(px_width, px_height, pixels);
+    if (strcmp(algorithm, "kruskal") == 0) return new KruskalMaze(px_width, px_height, pixels);
+    if (strcmp(algorithm, "prim") == 0) return new PrimMaze(px_width, px_height, pixels);
+    if (strcmp(algorithm, "eller") == 0) return new EllerMaze(px_width, px_height, pixels);
+    return new DfsMaze(px_width, px_height, pixels);
 }
 
-/*
-    Using the simple Depth-first search algorithm.
-
-    1. Start at a random cell.
-    2. Mark the current cell as visited, and get a list of its neighbors. 
-       For each neighbor, starting with a randomly selected neighbor:
-    3. If that neighbor hasn't been visited, remove the wall between this cell and that neighbor, 
-       and then recurse with that neighbor as the current cell.
-
-    NOTE: Using a stack instead of recursion to make use of the main() event loop.
-*/
-
-int mazePos2PixelIndex(Position pos, int px_width) {
-    return ((pos.y * 2 * px_width) + (pos.x * 2));
-}
-
-int wallIndexBetweenPositions(Position pos1, Position pos2, int px_width) {
-    // returns pixel index of wall between two cell positions in maze
-    // it's really the mid-point between the two cells
-    return ( ((pos1.y + pos2.y) * px_width) + (pos1.x + pos2.x) );
-}
-
-void drawMaze(std::stack<Position> &cell_stack, int px_width, int px_height, uint8_t pixels[]) {
-
-    if ( cell_stack.empty() ) { 
-        return;
+// Carving steps for this frame, so that the maze is done opt_finish seconds
+// after it was started. How many steps are left is guessed from how far the
+// maze got with the steps so far. Endless mazes carve a screenful in that time.
+int carvingSteps(const MazeGenerator *maze, long done, double elapsed, double frame_period) {
+
+    if (opt_finish == 0) { return INT_MAX; }
+    double frames_left = (opt_finish - elapsed) / frame_period;
+    double steps_left;
+    const double progress = maze->Progress();
+    if (progress < 0) {
+        steps_left = maze->cells();
+        frames_left = opt_finish / frame_period;
+    } else if (progress > 0) {
+        steps_left = done / progress - done;
+    } else {
+        steps_left = 2.0 * maze->cells();
     }
+    if (frames_left < 1) { frames_left = 1; }
+    const double steps = ceil(steps_left / frames_left);
+    if (steps < 1) { return 1; }
+    return (steps < INT_MAX) ? (int)steps : INT_MAX;
+}
 
-    int maze_width = (px_width / 2.0f) + 0.5;
-    int maze_height = (px_height / 2.0f) + 0.5;
-    Position pos = cell_stack.top();
-
-    // mark current pos as forground
-    int cur_idx = mazePos2PixelIndex(pos, px_width);
-    pixels[cur_idx] = kColorMaze;
+// Carve this frame's steps, as far as half a frame allows. The other half
+// is for drawing. False once the maze is finished.
+bool carveFrame(MazeGenerator *maze, const FrameTimer &timer, int64_t start, long *carved) {
 
-    // create list of neighbors not yet visited, handling edge cases
-    int n=0, temp_idx, wall_idx;
-    Position neighbor[4];
-    if (pos.y > 0) { 
-        temp_idx = (((pos.y - 1) * 2 * px_width) + (pos.x * 2));
-        if (pixels[temp_idx] == kColorBG) { neighbor[n++] = Position(pos.x, pos.y - 1); }
-    }
-    if (pos.y < maze_height - 1) { 
-        temp_idx = (((pos.y + 1) * 2 * px_width) + (pos.x * 2)); 
-        if (pixels[temp_idx] == kColorBG) { neighbor[n++] = Position(pos.x, pos.y + 1); }
-    }
-    if (pos.x > 0) { 
-        temp_idx = ((pos.y * 2 * px_width) + ((pos.x - 1) * 2)); 
-        if (pixels[temp_idx] == kColorBG) { neighbor[n++] = Position(pos.x - 1, pos.y); }
+    const int steps = carvingSteps(maze, *carved, (nowMicros() - start) / 1e6, timer.period());
+    for (int i=0; i < steps; i++) {
+        if (!maze->Step()) { return false; }
+        (*carved)++;
+        if ((i & 63) == 63 && !timer.HasTime(opt_delay * 500)) { break; }
     }
-    if (pos.x < maze_width - 1) { 
-        temp_idx = ((pos.y * 2 * px_width) + ((pos.x + 1) * 2)); 
-        if (pixels[temp_idx] == kColorBG) { neighbor[n++] = Position(pos.x + 1, pos.y); }
-    }
-
-    // pick a random neighbor
-    if (n > 0) {
-        int rand_idx = randomInt(0, n - 1);
+    return true;
+}
 
-        // draw wall
-        wall_idx = wallIndexBetweenPositions(pos, neighbor[rand_idx], px_width);
-        pixels[wall_idx] = kColorMaze;
+// NULL for no solver
+MazeSolver *newSolver(const char *solver, int px_width, int px_height, uint8_t pixels[]) {
 
-        cell_stack.push( neighbor[rand_idx] );
-    }
-    else {
-        // no neighbors left
-        // mark pos as visited then pop off stack
-        pixels[cur_idx] = kColorVisited;
-        cell_stack.pop();
-
-        // draw visited wall
-        if ( !cell_stack.empty() ) { 
-            Position pos2 = cell_stack.top();
-            wall_idx = wallIndexBetweenPositions(pos, pos2, px_width);
-            pixels[wall_idx] = kColorVisited;
-        }
-    }
+    if (strcmp(solver, "astar") == 0) return new MazeSolver(px_width, px_height, pixels, MazeSolver::ASTAR);
+    if (strcmp(solver, "wall") == 0) return new MazeSolver(px_width, px_height, pixels, MazeSolver::WALL_FOLLOWER);
+    if (strcmp(solver, "bfs") == 0) return new MazeSolver(px_width, px_height, pixels, MazeSolver::BFS);
+    return NULL;
 }
 
 int main(int argc, char *argv[]) {
@@ -295,6 +307,11 @@ int main(int argc, char *argv[]) {
     Color fg_color = Color(opt_fg_R, opt_fg_G, opt_fg_B);
     Color bg_color = Color(opt_bg_R, opt_bg_G, opt_bg_B);
     Color vc_color = Color(opt_vc_R, opt_vc_G, opt_vc_B);
+    Color colors[5];   // by pixel value
+    colors[kColorBG] = bg_color;
+    colors[kColorMaze] = fg_color;
+    colors[kColorFrontier] = Color(opt_fr_R, opt_fr_G, opt_fr_B);
+    colors[kColorPath] = Color(opt_pa_R, opt_pa_G, opt_pa_B);
 
     // open socket and create our canvas
     const int socket = OpenFlaschenTaschenSocket(opt_hostname);
@@ -304,18 +321,17 @@ int main(int argc, char *argv[]) {
     // pixel buffer
     int psize = opt_width * opt_height;
     uint8_t pixels[psize];
+    uint8_t shown[psize];   // pixel values on the canvas, none yet
     for (int i=0; i < psize; i++) { 
         pixels[i] = kColorBG;
+        shown[i] = 0xFF;
     }
 
     // setup maze
-    int maze_width = opt_width / 2;
-    int maze_height = opt_height / 2;
-    std::stack<Position> cell_stack;
-
-    // random initial position
-    Position maze_pos = Position( randomInt(0, maze_width - 1), randomInt(0, maze_height - 1) );
-    cell_stack.push(maze_pos);
+    MazeGenerator *maze = newMaze(opt_algorithm, opt_width, opt_height, pixels);
+    MazeSolver *solver = NULL;
+    int expansions = opt_expansions;
+    long carved = 0;
 
     // handle break
     signal(SIGTERM, InterruptHandler);
@@ -324,21 +340,37 @@ int main(int argc, char *argv[]) {
     // other vars
     int count = 0, colr = 0;
     time_t starttime = time(NULL);
+    const int64_t carve_start = nowMicros();
+    FrameTimer timer(opt_delay);
 
     do {
-        drawMaze(cell_stack, opt_width, opt_height, pixels);
+        timer.Start();
+        if (solver) {
+            solver->Step(expansions);
+        } else if (!carveFrame(maze, timer, carve_start, &carved) &&
+                   (solver = newSolver(opt_solver, opt_width, opt_height, pixels))) {
+            // spread the search over SOLVE_TIME worth of frames
+            if (expansions == 0) {
+                expansions = solver->cells() * opt_delay / (SOLVE_TIME * 1000);
+                if (expansions < 1) { expansions = 1; }
+            }
+        }
 
         // set pixel color if cycling through palette
         if (!opt_vcolor) {
             vc_color = palette[colr];
         }
+        colors[kColorVisited] = vc_color;
 
-        // copy pixel buffer to canvas
+        // copy the changed pixels to the canvas. Visited ones all change
+        // color when cycling through the palette.
         int dst = 0;
         for (int y=0; y < opt_height; y++) {
             for (int x=0; x < opt_width; x++) {
-                canvas.SetPixel( x, y, ((pixels[dst] == kColorVisited) ? 
-                    vc_color : ((pixels[dst] == kColorMaze) ? fg_color : bg_color)) );
+                if (pixels[dst] != shown[dst] || (!opt_vcolor && pixels[dst] == kColorVisited)) {
+                    canvas.SetPixel( x, y, colors[pixels[dst]] );
+                    shown[dst] = pixels[dst];
+                }
                 dst++;
             }
         }
@@ -346,7 +378,7 @@ int main(int argc, char *argv[]) {
         // send canvas
         canvas.SetOffset(opt_xoff + DISPLAY_XOFF, opt_yoff + DISPLAY_YOFF, opt_layer);
         canvas.Send();
-        usleep(opt_delay * 1000);
+        timer.Sleep();
 
         count++;
         if (count == INT_MAX) { count=0; }
@@ -354,7 +386,10 @@ int main(int argc, char *argv[]) {
         colr++;
         if (colr >= 256) { colr=0; }
 
-    } while ( (difftime(time(NULL), starttime) <= opt_timeout) && !interrupt_received ); // && !cell_stack.empty()
+    } while ( (difftime(time(NULL), starttime) <= opt_timeout) && !interrupt_received );
+
+    delete solver;
+    delete maze;
 
     // clear canvas on exit
     canvas.Clear();
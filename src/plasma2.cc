@@ -7,7 +7,8 @@
 //
 // Displays animated plasma effect on the Flaschen Taschen.
 // This version uses anti-aliasing to smooth out jittering by 
-// supersampling by 4x and down-sampling to the display resolution.
+// supersampling by 4x and down-sampling to the display resolution,
+// one cache-sized tile at a time.
 //
 // How to run:
 //
@@ -39,6 +40,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "image-scale.h"
 
 #include <stdio.h>
 #include <unistd.h>
@@ -46,10 +48,16 @@
 #include <stdint.h>
 #include <math.h>
 #include <limits.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define Z_LAYER 1      // (0-15) 0=background
 #define DELAY 10
 #define PALETTE_MAX 4  // 0=Rainbow, 1=Nebula, 2=Fire, 3=Bluegreen, 4=RGB
+#define TILE_WIDTH 64  // display pixels per tile, keeps the working set in L1
 
 void colorGradient(int start, int end, int r1, int g1, int b1, int r2, int g2, int b2, Color palette[]) {
     float k;
@@ -113,6 +121,63 @@ void setPalette(int num, Color palette[]) {
     }
 }
 
+// --------------------------------------------------------------------------------
+// Supersampling
+//
+// Instead of rendering the whole supersampled frame and then reducing it,
+// each display row is rendered in tiles of TILE_WIDTH display pixels.
+// One supersampled row of a tile is computed at a time, converted to planar
+// r,g,b through the palette, and summed into 16-bit column accumulators.
+// Once all 'scale' rows are in, each group of 'scale' columns is averaged
+// and written straight to the canvas.
+
+// sum of the three plasma windows for one supersampled row (wraps at 8 bits)
+void plasmaRow(const uint8_t *p1, const uint8_t *p2, const uint8_t *p3, uint8_t *out, int n) {
+    int x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= n; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p1 + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p2 + x));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p3 + x));
+        _mm_storeu_si128((__m128i *)(out + x), _mm_add_epi8(_mm_add_epi8(a, b), c));
+    }
+#endif
+    for (; x < n; x++) {
+        out[x] = (uint8_t)(p1[x] + p2[x] + p3[x]);
+    }
+}
+
+// Render display row 'y', columns [x0, x0 + tw), with the plasma windows
+// starting at src1..src3 (offsets of display pixel (0,0) in the plasma
+// buffers, which are 'pitch' wide).
+void renderTile(UDPFlaschenTaschen &canvas, const Color palette[],
+                const uint8_t *plasma1, const uint8_t *plasma2,
+                int src1, int src2, int src3, int pitch,
+                int x0, int y, int tw, int scale,
+                uint8_t *idx, uint8_t *chan[3], uint16_t *acc[3]) {
+    const int sw = tw * scale;
+    const int sx = x0 * scale;
+    for (int c=0; c < 3; c++) { memset(acc[c], 0, sw * sizeof(uint16_t)); }
+
+    for (int sy = y * scale; sy < (y + 1) * scale; sy++) {
+        const int row = sy * pitch + sx;
+        plasmaRow(plasma1 + src1 + row, plasma2 + src2 + row, plasma2 + src3 + row, idx, sw);
+        for (int x=0; x < sw; x++) {
+            const Color &col = palette[idx[x]];
+            chan[0][x] = col.r;
+            chan[1][x] = col.g;
+            chan[2][x] = col.b;
+        }
+        for (int c=0; c < 3; c++) { accumulateRow(chan[c], acc[c], sw); }
+    }
+
+    // box filter the accumulated columns down to display pixels
+    for (int c=0; c < 3; c++) { boxReduceRow(acc[c], scale, chan[c], tw); }
+    for (int x=0; x < tw; x++) {
+        canvas.SetPixel( x0 + x, y, Color(chan[0][x], chan[1][x], chan[2][x]) );
+    }
+}
+
 int main(int argc, char *argv[]) {
     const char *hostname = NULL;   // will use default if not set otherwise
     if (argc > 1) {
@@ -134,12 +199,9 @@ int main(int argc, char *argv[]) {
     Color palette[256];
     //setPalette(0);
 
-    // pixel buffer
-    uint8_t pixels[ dwidth * dheight ];
-
-    // init precalculated plasma buffers
-    uint8_t plasma1[ dwidth * dheight * 4 ];
-    uint8_t plasma2[ dwidth * dheight * 4 ];
+    // init precalculated plasma buffers (on the heap, these get large)
+    uint8_t *plasma1 = new uint8_t[ dwidth * dheight * 4 ];
+    uint8_t *plasma2 = new uint8_t[ dwidth * dheight * 4 ];
     int dst = 0;
     for (int y=0; y < (dheight * 2); y++) {
         for (int x=0; x < (dwidth * 2); x++) {
@@ -154,6 +216,16 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // per-tile scratch buffers
+    const int tile_sw = TILE_WIDTH * scale;
+    uint8_t *idx = new uint8_t[ tile_sw ];
+    uint8_t *chan[3];
+    uint16_t *acc[3];
+    for (int c=0; c < 3; c++) {
+        chan[c] = new uint8_t[ tile_sw ];
+        acc[c] = new uint16_t[ tile_sw ];
+    }
+
     //double foo = 3;   // for 1x
     //double foo = 10;  // for 2x
     double foo = 10;    // for 4x
@@ -183,82 +255,13 @@ int main(int argc, char *argv[]) {
         src2 = y2 * dwidth * 2 + x2;
         src3 = y3 * dwidth * 2 + x3;
 
-        // write plasma to pixel buffer
-        dst = 0;
-        for (int y=0; y < dheight; y++) {
-            for (int x=0; x < dwidth; x++) {
-                // plot pixel as sum of plasma functions
-                pixels[dst] = (uint8_t)((plasma1[src1] + plasma2[src2] + plasma2[src3]) & 0xFF);
-                //pixels[dst] = (uint8_t)((plasma1[src1]) & 0xFF);
-                //pixels[dst] = (uint8_t)((plasma2[src2]) & 0xFF);
-                dst++; src1++; src2++; src3++;
-            }
-            // skip to next line in plasma buffers
-            src1 += dwidth; src2 += dwidth; src3 += dwidth;
-        }
-
-        // copy pixel buffer to canvas
-        uint8_t dot_r, dot_g, dot_b;
-        int src = 0;
-        dst = 0;
+        // render plasma tile by tile, anti-aliased straight into the canvas
         for (int y=0; y < height; y++) {
-            for (int x=0; x < width; x++) {
-                
-                // anti-alias by down-sampling (averaging) 4 pixels to 1
-
-                // TEST
-                /*
-                dot_r = palette[pixels[src]].r;
-                dot_g = palette[pixels[src]].g;
-                dot_b = palette[pixels[src]].b;
-                //*/
-
-              if (scale == 2) {
-                // subsample 2x2 pixels to 1
-                dot_r = ( palette[pixels[src]].r + palette[pixels[src + 1]].r 
-                        + palette[pixels[src + dwidth]].r + palette[pixels[src + dwidth + 1]].r ) >> 2;
-                dot_g = ( palette[pixels[src]].g + palette[pixels[src + 1]].g 
-                        + palette[pixels[src + dwidth]].g + palette[pixels[src + dwidth + 1]].g ) >> 2;
-                dot_b = ( palette[pixels[src]].b + palette[pixels[src + 1]].b 
-                        + palette[pixels[src + dwidth]].b + palette[pixels[src + dwidth + 1]].b ) >> 2;
-              }
-              else if (scale == 4) {
-                // subsample 4x4 pixels to 1
-                dot_r = ( palette[pixels[src + 0]].r + palette[pixels[src + 1]].r
-                        + palette[pixels[src + 2]].r + palette[pixels[src + 3]].r
-                        + palette[pixels[src + dwidth + 0]].r + palette[pixels[src + dwidth + 1]].r
-                        + palette[pixels[src + dwidth + 2]].r + palette[pixels[src + dwidth + 3]].r
-                        + palette[pixels[src + (dwidth * 2) + 0]].r + palette[pixels[src + (dwidth * 2) + 1]].r
-                        + palette[pixels[src + (dwidth * 2) + 2]].r + palette[pixels[src + (dwidth * 2) + 3]].r
-                        + palette[pixels[src + (dwidth * 3) + 0]].r + palette[pixels[src + (dwidth * 3) + 1]].r
-                        + palette[pixels[src + (dwidth * 3) + 2]].r + palette[pixels[src + (dwidth * 3) + 3]].r
-                        ) >> 4;
-                dot_g = ( palette[pixels[src + 0]].g + palette[pixels[src + 1]].g
-                        + palette[pixels[src + 2]].g + palette[pixels[src + 3]].g
-                        + palette[pixels[src + dwidth + 0]].g + palette[pixels[src + dwidth + 1]].g
-                        + palette[pixels[src + dwidth + 2]].g + palette[pixels[src + dwidth + 3]].g
-                        + palette[pixels[src + (dwidth * 2) + 0]].g + palette[pixels[src + (dwidth * 2) + 1]].g
-                        + palette[pixels[src + (dwidth * 2) + 2]].g + palette[pixels[src + (dwidth * 2) + 3]].g
-                        + palette[pixels[src + (dwidth * 3) + 0]].g + palette[pixels[src + (dwidth * 3) + 1]].g
-                        + palette[pixels[src + (dwidth * 3) + 2]].g + palette[pixels[src + (dwidth * 3) + 3]].g
-                        ) >> 4;
-                dot_b = ( palette[pixels[src + 0]].b + palette[pixels[src + 1]].b
-                        + palette[pixels[src + 2]].b + palette[pixels[src + 3]].b
-                        + palette[pixels[src + dwidth + 0]].b + palette[pixels[src + dwidth + 1]].b
-                        + palette[pixels[src + dwidth + 2]].b + palette[pixels[src + dwidth + 3]].b
-                        + palette[pixels[src + (dwidth * 2) + 0]].b + palette[pixels[src + (dwidth * 2) + 1]].b
-                        + palette[pixels[src + (dwidth * 2) + 2]].b + palette[pixels[src + (dwidth * 2) + 3]].b
-                        + palette[pixels[src + (dwidth * 3) + 0]].b + palette[pixels[src + (dwidth * 3) + 1]].b
-                        + palette[pixels[src + (dwidth * 3) + 2]].b + palette[pixels[src + (dwidth * 3) + 3]].b
-                        ) >> 4;
-              }
-
-                //canvas.SetPixel( x, y, palette[ pixels[dst] ] );
-                canvas.SetPixel( x, y, Color(dot_r, dot_g, dot_b) );
-                dst++; src += scale;
+            for (int x=0; x < width; x += TILE_WIDTH) {
+                int tw = (width - x < TILE_WIDTH) ? (width - x) : TILE_WIDTH;
+                renderTile(canvas, palette, plasma1, plasma2, src1, src2, src3, dwidth * 2,
+                           x, y, tw, scale, idx, chan, acc);
             }
-            //src += dwidth;  // skip every other row (2x)
-            src += (dwidth * 2);  // skip every other row (4x)
         }
 
         // send canvas
@@ -40,6 +40,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "config.h"
+#include "ifs.h"
 
 #include <getopt.h>
 #include <stdio.h>
@@ -56,6 +57,7 @@
 // Defaults
 #define Z_LAYER 2      // (0-15) 0=background
 #define DELAY 20
+#define POINTS 1000000
 
 volatile bool interrupt_received = false;
 static void InterruptHandler(int signo) {
@@ -77,6 +79,9 @@ int opt_delay  = DELAY;
 bool opt_fgcolor = false, opt_bgcolor = false;
 int opt_fg_R=0, opt_fg_G=0, opt_fg_B=0;
 int opt_bg_R=1, opt_bg_G=1, opt_bg_B=1;
+Ifs opt_ifs;
+int opt_points = POINTS;
+int opt_threads = -1;  // worker threads, default one per core
 
 int usage(const char *progname) {
 
@@ -91,6 +96,10 @@ int usage(const char *progname) {
         "\t-d <delay>     : Delay between frames in milliseconds. (default 20)\n"
         "\t-c <RRGGBB>    : Forground color in hex (-c0 = transparent, default cycles)\n"
         "\t-b <RRGGBB>    : Background color in hex (-b0 = transparent, default black)\n"
+        "\t-i <ifs>       : sierpinski, fern, dragon, or maps a,b,c,d,e,f[,p];...\n"
+        "\t                 x' = ax + by + e, y' = cx + dy + f. (default sierpinski)\n"
+        "\t-n <points>    : Points plotted per frame. (default 1000000)\n"
+        "\t-j <threads>   : Threads plotting points. (default 1 per core)\n"
     );
     return 1;
 }
@@ -99,7 +108,7 @@ int cmdLine(int argc, char *argv[]) {
 
     // command line options
     int opt;
-    while ((opt = getopt(argc, argv, "?g:l:t:r:h:d:c:b:n:")) != -1) {
+    while ((opt = getopt(argc, argv, "?g:l:t:r:h:d:c:b:i:n:j:")) != -1) {
         switch (opt) {
         case '?':  // help
             return usage(argv[0]);
@@ -151,6 +160,26 @@ int cmdLine(int argc, char *argv[]) {
             }
             opt_bgcolor = true;
             break;
+        case 'i':  // iterated function system
+            if (!opt_ifs.Parse(optarg)) {
+                fprintf(stderr, "Invalid IFS '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'n':  // points per frame
+            if (sscanf(optarg, "%d", &opt_points) != 1 || opt_points < 1) {
+                fprintf(stderr, "Invalid number of points '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            break;
+        case 'j':  // threads
+            if (sscanf(optarg, "%d", &opt_threads) != 1 || opt_threads < 1) {
+                fprintf(stderr, "Invalid number of threads '%s'\n", optarg);
+                return usage(argv[0]);
+            }
+            // the main thread plots too
+            opt_threads--;
+            break;
         default:
             return usage(argv[0]);
         }
@@ -179,6 +208,7 @@ int main(int argc, char *argv[]) {
 
     // parse command line
     if (int e = cmdLine(argc, argv)) { return e; }
+    if (opt_ifs.maps.empty()) { opt_ifs.Parse("sierpinski"); }
 
     // seed the random generator
     srandom(time(NULL));
@@ -195,20 +225,22 @@ int main(int argc, char *argv[]) {
     colorGradient( 224, 255, 255, 0,   0,   255, 0,   255, palette );
 
     // setup colors
-    Color fg_color, bg_color = Color(opt_bg_R, opt_bg_G, opt_bg_B);
-    if (opt_fgcolor) {
-        fg_color = Color(opt_fg_R, opt_fg_G, opt_fg_B);
-    }
+    Color fg_color = Color(opt_fg_R, opt_fg_G, opt_fg_B);
+    Color bg_color = Color(opt_bg_R, opt_bg_G, opt_bg_B);
+    Color shades[256];   // by density, from a quarter bright up to fg_color
 
     // open socket and create our canvas
     const int socket = OpenFlaschenTaschenSocket(opt_hostname);
     UDPFlaschenTaschen canvas(socket, opt_width, opt_height);
     canvas.Clear();
 
-    // pixel buffer
+    // pixel buffer, of densities
     uint8_t pixels[ opt_width * opt_height ];
     for (int i=0; i < opt_width * opt_height; i++) { pixels[i] = 0; }  // clear pixel buffer
 
+    ThreadPool *pool = (opt_threads != 0) ? new ThreadPool(opt_threads) : NULL;
+    IfsRenderer ifs(opt_width, opt_height, opt_ifs, pool);
+
     // handle break
     signal(SIGTERM, InterruptHandler);
     signal(SIGINT, InterruptHandler);
@@ -218,29 +250,16 @@ int main(int argc, char *argv[]) {
     time_t starttime = time(NULL);
     time_t respawn_time = starttime;
 
-    // sierpinski vars
-    double sx = (double)random() / (double)(RAND_MAX);
-    double sy = (double)random() / (double)(RAND_MAX);
-    static const double sx0[3] = { 0.5f, 0, 1 };
-    static const double sy0[3] = {    1, 0, 0 };
-    int sxp, syp;
-
     do {
-        // draw a dot of sierpinski's triangle
-        int sn = randomInt(0, 2);
-        sx = (sx + sx0[sn]) / 2.0f;
-        sy = (sy + sy0[sn]) / 2.0f;
-        //sxp = floor((opt_width - 1) * (sx + 0.1f) / 1.2f);
-        //syp = opt_height - floor((opt_height - 1) * (sy + 0.1f) / 1.2f);
-        sxp = floor((opt_width - 1) * sx);
-        syp = opt_height - floor((opt_height - 1) * sy) - 1;
-        pixels[(syp * opt_width) + sxp] = 1;
+        // plot the next points of the fractal
+        ifs.Render(opt_points);
+        ifs.ToneMap(pixels);
 
         // check for respawn
         if (opt_respawn > 0) {
             if (difftime(time(NULL), respawn_time) > opt_respawn) {
                 respawn_time = time(NULL);
-                for (int i=0; i < opt_width * opt_height; i++) { pixels[i] = 0; }  // clear pixel buffer
+                ifs.Clear();
             }
         }
 
@@ -248,12 +267,15 @@ int main(int argc, char *argv[]) {
         if (!opt_fgcolor) {
             fg_color = palette[colr];
         }
+        shades[0] = bg_color;
+        colorGradient( 1, 255, fg_color.r / 4, fg_color.g / 4, fg_color.b / 4,
+                       fg_color.r, fg_color.g, fg_color.b, shades );
 
         // copy pixel buffer to canvas
         int dst = 0;
         for (int y=0; y < opt_height; y++) {
             for (int x=0; x < opt_width; x++) {
-                canvas.SetPixel( x, y, (pixels[dst] ? fg_color : bg_color) );
+                canvas.SetPixel( x, y, shades[pixels[dst]] );
                 dst++;
             }
         }
@@ -271,6 +293,8 @@ int main(int argc, char *argv[]) {
 
     } while ( (difftime(time(NULL), starttime) <= opt_timeout) && !interrupt_received );
 
+    delete pool;
+
     // clear canvas on exit
     canvas.Clear();
     canvas.Send();
@@ -0,0 +1,154 @@
+// -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; -*-
+//
+// thread-pool.h
+// Copyright (c) 2016 Carl Gorringe (carl.gorringe.org)
+// https://github.com/cgorringe/ft-demos
+// 10/19/2026
+//
+// A small pool of worker threads for splitting work such as the rows of a
+// frame across cores. Work is handed out one item at a time from a shared
+// counter, so expensive items don't leave the other threads idle.
+//
+// Usage:
+//
+//  ThreadPool pool(-1);                     // -1 = one thread per core
+//  pool.Start(height, computeRow);          // returns right away
+//  ...                                      // display something else
+//  pool.Wait();                             // all rows done
+//
+// The calling thread helps out while it waits, so a pool with no worker
+// threads still gets the job done (on the calling thread).
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation version 2.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://gnu.org/licenses/gpl-2.0.txt>
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // Creates 'num_threads' workers. -1 uses one per core, but as the
+    // calling thread also works while waiting, that's one less than cores.
+    explicit ThreadPool(int num_threads) : count_(0), next_(0), done_(0),
+                                           generation_(0), active_(0), quit_(false) {
+        if (num_threads < 0) {
+            num_threads = (int)std::thread::hardware_concurrency() - 1;
+        }
+        for (int i=0; i < num_threads; i++) {
+            workers_.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+        }
+    }
+
+    ~ThreadPool() {
+        Wait();
+        {
+            std::lock_guard<std::mutex> l(mutex_);
+            quit_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i=0; i < workers_.size(); i++) { workers_[i].join(); }
+    }
+
+    // number of worker threads (not counting the caller)
+    int size() const { return (int)workers_.size(); }
+
+    // Start calling fn(0) .. fn(count-1) on the workers and return right
+    // away. A previous job must have been waited for.
+    void Start(int count, const std::function<void(int)> &fn) {
+        std::unique_lock<std::mutex> l(mutex_);
+        // a worker that woke up late for the last job may still be leaving it
+        finished_.wait(l, [this]() { return active_ == 0; });
+        fn_ = fn;
+        count_ = count;
+        next_ = 0;
+        done_ = 0;
+        generation_++;
+        wake_.notify_all();
+    }
+
+    // Help with the current job until it is finished.
+    void Wait() {
+        while (RunOne()) {}
+        std::unique_lock<std::mutex> l(mutex_);
+        finished_.wait(l, [this]() { return done_ >= count_ && active_ == 0; });
+    }
+
+    // Start() and Wait() in one.
+    void Run(int count, const std::function<void(int)> &fn) {
+        Start(count, fn);
+        Wait();
+    }
+
+    // Process one item of the current job on the calling thread.
+    // Returns false if there are no items left to hand out.
+    bool RunOne() {
+        const int i = next_.fetch_add(1);
+        if (i >= count_) return false;
+        fn_(i);
+        Finished();
+        return true;
+    }
+
+    // items of the current job completed so far
+    int completed() const { return done_; }
+    bool done() const { return done_ >= count_; }
+
+private:
+    void Finished() {
+        if (done_.fetch_add(1) + 1 >= count_) {
+            std::lock_guard<std::mutex> l(mutex_);
+            finished_.notify_all();
+        }
+    }
+
+    void WorkerLoop() {
+        int seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> l(mutex_);
+                wake_.wait(l, [this, seen]() { return quit_ || generation_ != seen; });
+                if (quit_) return;
+                seen = generation_;
+                active_++;
+            }
+            while (RunOne()) {}
+            {
+                // let Wait() know this worker is idle again
+                std::lock_guard<std::mutex> l(mutex_);
+                active_--;
+                finished_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::function<void(int)> fn_;
+    std::atomic<int> count_;
+    std::atomic<int> next_;
+    std::atomic<int> done_;
+    int generation_;
+    int active_;     // workers currently inside a job
+    bool quit_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+};
+
+#endif  // THREAD_POOL_H
@@ -20,6 +20,7 @@
 
 #include "udp-flaschen-taschen.h"
 #include "bdf-font.h"
+#include "blur-kernels.h"
 #include "config.h"
 
 #include <getopt.h>
@@ -217,15 +218,8 @@ void setPalette(int num, Color palette[]) {
 
 void blur(int width, int height, uint8_t pixels[]) {
 
-    int size = width * (height - 1) - 1;
-    uint8_t dot;
     // blur effect
-    for (int i=0; i < size; i++) {
-        dot = (uint8_t)((pixels[i] + pixels[i + 1] + pixels[i + width] + pixels[i + width + 1]) >> 2) & 0xFF;
-        if (dot <= BLUR_DROP) { dot = 0; }
-        else { dot -= BLUR_DROP; }
-        pixels[i] = dot;
-    }
+    blurBox(pixels, width * (height - 1) - 1, width, BLUR_DROP);
 }
 
 // --------------------------------------------------------------------------------